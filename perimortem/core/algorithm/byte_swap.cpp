@@ -0,0 +1,84 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/algorithm/byte_swap.hpp"
+
+#include "perimortem/core/data.hpp"
+
+using namespace Perimortem::Core;
+
+#include <x86intrin.h>
+
+namespace Perimortem::Core::Algorithm {
+
+// Shuffle that reverses each `width` byte element in a lane. The same mask is
+// used for both lanes since elements never straddle them.
+template <Count width>
+static auto reverse_mask() -> __m256i {
+  alignas(__m256i) Bits_8 mask[sizeof(__m256i)];
+  for (Count i = 0; i < sizeof(__m256i); i++) {
+    mask[i] = Bits_8(i - i % width + (width - 1 - i % width));
+  }
+
+  return _mm256_load_si256(Data::cast<const __m256i>(mask));
+}
+
+template <Count width>
+static auto swap_element(Bits_8* dest, const Bits_8* source) -> void {
+  if constexpr (width == 2) {
+    Bits_16 value;
+    memcpy(&value, source, width);
+    value = __builtin_bswap16(value);
+    memcpy(dest, &value, width);
+  } else if constexpr (width == 4) {
+    Bits_32 value;
+    memcpy(&value, source, width);
+    value = __builtin_bswap32(value);
+    memcpy(dest, &value, width);
+  } else {
+    Bits_64 value;
+    memcpy(&value, source, width);
+    value = __builtin_bswap64(value);
+    memcpy(dest, &value, width);
+  }
+}
+
+template <Count width>
+auto copy_swapped(Bits_8* dest, const Bits_8* source, Count count) -> void {
+  static_assert(width == 2 || width == 4 || width == 8);
+
+  const Count size = count * width;
+  Count i = 0;
+  if (size >= sizeof(__m256i)) {
+    const auto mask = reverse_mask<width>();
+
+    // Two vectors at a time keeps both shuffle ports busy on large tables.
+    for (; i + 2 * sizeof(__m256i) <= size; i += 2 * sizeof(__m256i)) {
+      const auto a =
+          _mm256_loadu_si256(Data::cast<const __m256i_u>(source + i));
+      const auto b = _mm256_loadu_si256(
+          Data::cast<const __m256i_u>(source + i + sizeof(__m256i)));
+      _mm256_storeu_si256(Data::cast<__m256i_u>(dest + i),
+                          _mm256_shuffle_epi8(a, mask));
+      _mm256_storeu_si256(Data::cast<__m256i_u>(dest + i + sizeof(__m256i)),
+                          _mm256_shuffle_epi8(b, mask));
+    }
+
+    for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+      const auto a =
+          _mm256_loadu_si256(Data::cast<const __m256i_u>(source + i));
+      _mm256_storeu_si256(Data::cast<__m256i_u>(dest + i),
+                          _mm256_shuffle_epi8(a, mask));
+    }
+  }
+
+  for (; i < size; i += width) {
+    swap_element<width>(dest + i, source + i);
+  }
+}
+
+template auto copy_swapped<2>(Bits_8*, const Bits_8*, Count) -> void;
+template auto copy_swapped<4>(Bits_8*, const Bits_8*, Count) -> void;
+template auto copy_swapped<8>(Bits_8*, const Bits_8*, Count) -> void;
+
+}  // namespace Perimortem::Core::Algorithm
@@ -0,0 +1,19 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/perimortem.hpp"
+
+namespace Perimortem::Core::Algorithm {
+
+// Copies `count` elements of `width` bytes from `source` to `dest`, reversing
+// the byte order of each one along the way. Used to convert whole arrays
+// between endians in one pass rather than swapping elements one at a time.
+//
+// Neither pointer needs to be aligned, but the ranges must not overlap.
+// Implemented for widths of 2, 4 and 8.
+template <Count width>
+auto copy_swapped(Bits_8* dest, const Bits_8* source, Count count) -> void;
+
+}  // namespace Perimortem::Core::Algorithm
@@ -0,0 +1,256 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/vector.hpp"
+#include "perimortem/core/access/vector.hpp"
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/data.hpp"
+#include "perimortem/core/math.hpp"
+
+namespace Perimortem::Core::Algorithm {
+
+// Immutable search index over a sorted View::Vector.
+//
+// Binary search over large arrays is bound by cache misses since every probe
+// lands on a new cache line and the hardware prefetcher can't guess which half
+// we'll pick. The index rebuilds the sorted keys into an implicit B+ tree
+// (S+ tree) where every node fills a single cache line, so a lookup touches
+// one line per level and the tree is ~log_17(N) levels deep instead of
+// log_2(N) for 32 bit keys.
+//
+// The leaf layer stores the original keys in sorted order which lets us return
+// the same index a `lower_bound` on the source array would without storing a
+// separate rank table. Internal layers add roughly 1 / node_keys of overhead.
+//
+// Batched lookups walk a group of queries through the tree level by level and
+// prefetch each query's next node before resolving the rest of the group,
+// overlapping the misses of independent lookups.
+//
+// Like `sort`, the index only requires a type to support `operator>` and the
+// type must be trivially copyable.
+template <typename type>
+class SearchIndex {
+ public:
+  // Keys per node. Nodes are sized to a cache line but keep at least 8 keys
+  // so the tree height stays bounded for large key types.
+  static constexpr Count node_keys =
+      Math::max(Count(Data::CacheAware::Enabled) / sizeof(type), Count(8));
+
+  // Number of queries resolved in lock step by the batched lookups.
+  static constexpr Count batch_width = 16;
+
+  // Enough levels for 2^64 keys at the minimum node width.
+  static constexpr Count max_height = 24;
+
+  SearchIndex() = default;
+  SearchIndex(const SearchIndex&) = delete;
+  SearchIndex(SearchIndex&& rhs)
+      : tree(rhs.tree),
+        size(rhs.size),
+        capacity(rhs.capacity),
+        height(rhs.height),
+        maximum(rhs.maximum) {
+    for (Count i = 0; i <= height; i++) {
+      layer_offsets[i] = rhs.layer_offsets[i];
+    }
+
+    rhs.tree = nullptr;
+    rhs.reset();
+  }
+
+  // The source must already be sorted, see `Algorithm::sort`.
+  SearchIndex(View::Vector<type> sorted) { build(sorted); }
+
+  ~SearchIndex() { reset(); }
+
+  auto build(View::Vector<type> sorted) -> void {
+    reset();
+
+    size = sorted.get_size();
+    if (size == 0) {
+      return;
+    }
+
+    // Layout the layers from the leaves up. Layer 0 is the leaf layer and each
+    // layer above holds one separator per child of the layer below.
+    height = 0;
+    Count keys = size;
+    Count offset = 0;
+    while (true) {
+      layer_offsets[height++] = offset;
+      offset += block_count(keys) * node_keys;
+      if (keys <= node_keys) {
+        break;
+      }
+
+      keys = parent_keys(keys);
+    }
+    layer_offsets[height] = offset;
+
+    auto alloc = Bibliotheca::check_out(offset * sizeof(type));
+    tree = Data::cast<type>(alloc.ptr);
+    capacity = alloc.capacity;
+
+    // Padding acts as positive infinity for any query that passes the upper
+    // bound check in `lower_bound`, so reusing the largest key is enough.
+    maximum = sorted[size - 1];
+    Data::copy(Data::cast<Bits_8>(tree), sorted.get_data(), size);
+    for (Count i = size; i < layer_offsets[1]; i++) {
+      tree[i] = maximum;
+    }
+
+    // Each separator is the smallest key of the subtree to the right of it,
+    // which is found by stepping right once and then left until a leaf.
+    for (Count layer = 1; layer < height; layer++) {
+      const Count layer_size = layer_offsets[layer + 1] - layer_offsets[layer];
+      for (Count i = 0; i < layer_size; i++) {
+        Count node = i / node_keys;
+        Count child = node * (node_keys + 1) + (i - node * node_keys) + 1;
+        for (Count descend = 1; descend < layer; descend++) {
+          child *= node_keys + 1;
+        }
+
+        const Count leaf = child * node_keys;
+        tree[layer_offsets[layer] + i] = leaf < size ? tree[leaf] : maximum;
+      }
+    }
+  }
+
+  auto reset() -> void {
+    if (tree) {
+      Bibliotheca::remit(Data::cast<Bits_8>(tree));
+    }
+
+    tree = nullptr;
+    size = 0;
+    capacity = 0;
+    height = 0;
+  }
+
+  // Returns the index of the first key that is not less than `value` in the
+  // source array, or `get_size()` if every key is less than `value`.
+  constexpr auto lower_bound(const type& value) const -> Count {
+    if (size == 0 || value > maximum) {
+      return size;
+    }
+
+    Count offset = 0;
+    for (Count layer = height - 1; layer > 0; layer--) {
+      const auto rank = node_rank(tree + layer_offsets[layer] + offset, value);
+      offset = offset * (node_keys + 1) + rank * node_keys;
+    }
+
+    return offset + node_rank(tree + offset, value);
+  }
+
+  constexpr auto contains(const type& value) const -> Bool {
+    const Count index = lower_bound(value);
+    return index < size && !(tree[index] > value);
+  }
+
+  // Batched `lower_bound`, writing one index per key.
+  auto lower_bound(View::Vector<type> keys, Access::Vector<Count> results) const
+      -> void {
+    const Count count = Math::min(keys.get_size(), results.get_size());
+    for (Count start = 0; start < count; start += batch_width) {
+      const Count group = Math::min(batch_width, count - start);
+      resolve_batch(keys.get_data() + start, results.get_data() + start, group);
+    }
+  }
+
+  // Batched `contains`, writing one result per key.
+  auto contains(View::Vector<type> keys, Access::Vector<Bool> results) const
+      -> void {
+    const Count count = Math::min(keys.get_size(), results.get_size());
+    Count indices[batch_width];
+    for (Count start = 0; start < count; start += batch_width) {
+      const Count group = Math::min(batch_width, count - start);
+      resolve_batch(keys.get_data() + start, indices, group);
+
+      for (Count i = 0; i < group; i++) {
+        results.get_data()[start + i] =
+            indices[i] < size && !(tree[indices[i]] > keys[start + i]);
+      }
+    }
+  }
+
+  constexpr auto get_size() const -> Count { return size; }
+  constexpr auto get_height() const -> Count { return height; }
+  constexpr auto get_memory_consumption() const -> Count { return capacity; }
+
+  // The leaf layer is the original sorted array.
+  constexpr auto get_view() const -> View::Vector<type> {
+    return View::Vector<type>(tree, size);
+  }
+
+ private:
+  static constexpr auto block_count(Count keys) -> Count {
+    return (keys + node_keys - 1) / node_keys;
+  }
+
+  // Number of separators the layer above needs to route to every block.
+  static constexpr auto parent_keys(Count keys) -> Count {
+    return (block_count(keys) + node_keys) / (node_keys + 1) * node_keys;
+  }
+
+  // Count the keys in the node smaller than the value.
+  // Kept branchless so the compiler can vectorize it for integer keys.
+  static constexpr auto node_rank(const type* node, const type& value)
+      -> Count {
+    Count rank = 0;
+    for (Count i = 0; i < node_keys; i++) {
+      rank += (value > node[i]) ? 1 : 0;
+    }
+
+    return rank;
+  }
+
+  auto resolve_batch(const type* keys, Count* results, Count group) const
+      -> void {
+    if (size == 0) {
+      for (Count i = 0; i < group; i++) {
+        results[i] = 0;
+      }
+      return;
+    }
+
+    // Queries past the largest key would walk off the right edge of the tree,
+    // so they descend as the largest key instead and are fixed up at the end.
+    // This keeps the descent loop free of branches.
+    type probes[batch_width];
+    Count offsets[batch_width];
+    Bool beyond[batch_width];
+    for (Count i = 0; i < group; i++) {
+      beyond[i] = keys[i] > maximum;
+      probes[i] = beyond[i] ? maximum : keys[i];
+      offsets[i] = 0;
+    }
+
+    for (Count layer = height - 1; layer > 0; layer--) {
+      const type* base = tree + layer_offsets[layer];
+      const type* below = tree + layer_offsets[layer - 1];
+      for (Count i = 0; i < group; i++) {
+        const auto rank = node_rank(base + offsets[i], probes[i]);
+        offsets[i] = offsets[i] * (node_keys + 1) + rank * node_keys;
+        __builtin_prefetch(below + offsets[i]);
+      }
+    }
+
+    for (Count i = 0; i < group; i++) {
+      results[i] = beyond[i]
+                       ? size
+                       : offsets[i] + node_rank(tree + offsets[i], probes[i]);
+    }
+  }
+
+  type* tree = nullptr;
+  Count size = 0;
+  Count capacity = 0;
+  Count height = 0;
+  Count layer_offsets[max_height + 1] = {};
+  type maximum = type();
+};
+
+}  // namespace Perimortem::Core::Algorithm
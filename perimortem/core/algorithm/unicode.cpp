@@ -0,0 +1,199 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/algorithm/unicode.hpp"
+
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/data.hpp"
+
+using namespace Perimortem;
+using namespace Perimortem::Core;
+
+#include <x86intrin.h>
+
+namespace Perimortem::Core::Algorithm {
+
+// Flags for the error classes in the UTF-8 lookup validation. Each pair of
+// adjacent bytes is classified three ways by its high nibbles and the low
+// nibble of the first byte, and any class that survives all three lookups is
+// an error.
+static constexpr Bits_8 too_short = 1 << 0;       // 11______ 0_______
+static constexpr Bits_8 too_long = 1 << 1;        // 0_______ 10______
+static constexpr Bits_8 overlong_3 = 1 << 2;      // 11100000 100_____
+static constexpr Bits_8 too_large = 1 << 3;       // 11110100 1001____
+static constexpr Bits_8 surrogate = 1 << 4;       // 11101101 101_____
+static constexpr Bits_8 overlong_2 = 1 << 5;      // 1100000_ 10______
+static constexpr Bits_8 too_large_1000 = 1 << 6;  // 11110101 1000____
+static constexpr Bits_8 overlong_4 = 1 << 6;      // 11110000 1000____
+static constexpr Bits_8 two_conts = 1 << 7;       // 10______ 10______
+static constexpr Bits_8 carry = too_short | too_long | two_conts;
+
+static auto load_vector(const Bits_8* data) -> __m256i {
+  return _mm256_loadu_si256(Data::cast<const __m256i_u>(data));
+}
+
+// The 16 byte table is repeated in both lanes since the shuffle can't cross.
+static auto lookup(__m256i nibbles,
+                   Bits_8 a, Bits_8 b, Bits_8 c, Bits_8 d,
+                   Bits_8 e, Bits_8 f, Bits_8 g, Bits_8 h,
+                   Bits_8 i, Bits_8 j, Bits_8 k, Bits_8 l,
+                   Bits_8 m, Bits_8 n, Bits_8 o, Bits_8 p) -> __m256i {
+  const auto table = _mm256_setr_epi8(
+      a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p,
+      a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p);
+  return _mm256_shuffle_epi8(table, nibbles);
+}
+
+static auto high_nibbles(__m256i bytes) -> __m256i {
+  return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Bytes of `input` shifted back by `count`, pulling the gap from the end of
+// the previous block.
+template <int count>
+static auto previous(__m256i input, __m256i prior) -> __m256i {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(prior, input, 0x21), 16 - count);
+}
+
+static auto check_special_cases(__m256i input, __m256i prev1) -> __m256i {
+  const auto byte_1_high = lookup(
+      high_nibbles(prev1),
+      // 0_______ ASCII
+      too_long, too_long, too_long, too_long,
+      too_long, too_long, too_long, too_long,
+      // 10______ continuation
+      two_conts, two_conts, two_conts, two_conts,
+      // 1100____ and 1101____ two byte leads
+      too_short | overlong_2, too_short,
+      // 1110____ three byte lead
+      too_short | overlong_3 | surrogate,
+      // 1111____ four byte lead
+      too_short | too_large | too_large_1000 | overlong_4);
+
+  const auto byte_1_low = lookup(
+      _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)),
+      carry | overlong_3 | overlong_2 | overlong_4,
+      carry | overlong_2,
+      carry,
+      carry,
+      carry | too_large,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000 | surrogate,
+      carry | too_large | too_large_1000,
+      carry | too_large | too_large_1000);
+
+  const auto byte_2_high = lookup(
+      high_nibbles(input),
+      // ________ 0_______
+      too_short, too_short, too_short, too_short,
+      too_short, too_short, too_short, too_short,
+      // ________ 1000____
+      too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 |
+          overlong_4,
+      // ________ 1001____
+      too_long | overlong_2 | two_conts | overlong_3 | too_large,
+      // ________ 101_____
+      too_long | overlong_2 | two_conts | surrogate | too_large,
+      too_long | overlong_2 | two_conts | surrogate | too_large,
+      // ________ 11______
+      too_short, too_short, too_short, too_short);
+
+  return _mm256_and_si256(
+      _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+}
+
+// The pair lookups can't see 3 and 4 byte sequences, so they flag every
+// continuation after a continuation. Those flags have to line up exactly with
+// the bytes that a lead two or three bytes back expects.
+static auto check_multibyte_lengths(
+    __m256i input,
+    __m256i prior,
+    __m256i special_cases) -> __m256i {
+  const auto prev2 = previous<2>(input, prior);
+  const auto prev3 = previous<3>(input, prior);
+  const auto third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80));
+  const auto fourth_byte =
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80));
+  const auto expected = _mm256_and_si256(
+      _mm256_or_si256(third_byte, fourth_byte), _mm256_set1_epi8(0x80));
+  return _mm256_xor_si256(expected, special_cases);
+}
+
+// Marks a block that ends partway into a multi-byte sequence.
+static auto check_incomplete(__m256i input) -> __m256i {
+  const auto max_value = _mm256_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      Signed_8(0xF0 - 1), Signed_8(0xE0 - 1), Signed_8(0xC0 - 1));
+  return _mm256_subs_epu8(input, max_value);
+}
+
+auto validate_utf8(View::Bytes src) -> Bool {
+  constexpr Count block_size = sizeof(__m256i);
+
+  auto error = _mm256_setzero_si256();
+  auto prior = _mm256_setzero_si256();
+  auto prior_incomplete = _mm256_setzero_si256();
+
+  const auto check_block = [&](__m256i input) {
+    // ASCII blocks can only be wrong if the last one left a sequence open.
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = _mm256_or_si256(error, prior_incomplete);
+    } else {
+      const auto special_cases =
+          check_special_cases(input, previous<1>(input, prior));
+      error = _mm256_or_si256(
+          error, check_multibyte_lengths(input, prior, special_cases));
+      prior_incomplete = check_incomplete(input);
+    }
+
+    prior = input;
+  };
+
+  Count i = 0;
+  for (; i + block_size <= src.get_size(); i += block_size) {
+    check_block(load_vector(src.get_data() + i));
+  }
+
+  // The tail is padded out with zeros, which also closes off any sequence
+  // that was still open at the end of the text.
+  Static::Bytes<block_size> tail = src.slice(i, src.get_size() - i);
+  check_block(load_vector(tail.get_data()));
+
+  return _mm256_testz_si256(error, error);
+}
+
+auto utf16_length(View::Bytes src) -> Count {
+  constexpr Count block_size = sizeof(__m256i);
+
+  // Continuation bytes are the only ones that are <= -65 as signed, and 4 byte
+  // leads the only ones at or above 0xF0 which is -17.
+  const auto continuation_limit = _mm256_set1_epi8(-65);
+  const auto surrogate_limit = _mm256_set1_epi8(-17);
+
+  Count units = 0;
+  Count i = 0;
+  for (; i + block_size <= src.get_size(); i += block_size) {
+    const auto input = load_vector(src.get_data() + i);
+    const auto leads = _mm256_cmpgt_epi8(input, continuation_limit);
+    const auto pairs = _mm256_cmpgt_epi8(input, surrogate_limit);
+
+    // Signed compares would count ASCII as 4 byte leads, so mask those to the
+    // high bit.
+    const auto wide = _mm256_and_si256(pairs, input);
+    units += __builtin_popcount(Bits_32(_mm256_movemask_epi8(leads)));
+    units += __builtin_popcount(Bits_32(_mm256_movemask_epi8(wide)));
+  }
+
+  return units + utf16_length_scalar(src.slice(i, src.get_size() - i));
+}
+
+}  // namespace Perimortem::Core::Algorithm
@@ -0,0 +1,33 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+
+namespace Perimortem::Core::Algorithm {
+
+// Vectorized check that a View::Bytes is well formed UTF-8, rejecting overlong
+// encodings, surrogates, code points past U+10FFFF and truncated sequences.
+auto validate_utf8(View::Bytes src) -> Bool;
+
+// Number of UTF-16 code units needed to encode UTF-8 text.
+//
+// Only lead bytes are counted, plus one more for the 4 byte leads that become
+// surrogate pairs, so the count of two ranges adds up to the count of both
+// even when the split lands inside a code point. The text is assumed to be
+// valid.
+auto utf16_length(View::Bytes src) -> Count;
+
+// Scalar version of `utf16_length` for short runs.
+constexpr auto utf16_length_scalar(View::Bytes src) -> Count {
+  Count units = 0;
+  for (Count i = 0; i < src.get_size(); i++) {
+    units += (src[i] & 0xC0) != 0x80;
+    units += src[i] >= 0xF0;
+  }
+
+  return units;
+}
+
+}  // namespace Perimortem::Core::Algorithm
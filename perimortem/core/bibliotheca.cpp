@@ -355,6 +355,10 @@ auto Bibliotheca::remit(Bits_8* data) -> Count {
   return entry->reservations;
 }
 
+auto Bibliotheca::reservations(Bits_8* data) -> Count {
+  return corpus_to_preface(data)->reservations;
+}
+
 auto Bibliotheca::reserved_memory() -> Count {
   Count total_size = 0;
   for (int i = 0; i < radix_range; i++) {
@@ -49,6 +49,9 @@ class Bibliotheca final {
   // Bibliotheca for future use.
   static auto remit(Bits_8* entry) -> Count;
 
+  // The number of reservations currently held on a block.
+  static auto reservations(Bits_8* entry) -> Count;
+
   // Methods for analyzing the state of the Bibliotheca.
   static auto reserved_memory() -> Count;
   static auto free_memory() -> Count;
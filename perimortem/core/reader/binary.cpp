@@ -3,8 +3,10 @@
 
 #include "perimortem/core/reader/binary.hpp"
 
+#include "perimortem/core/algorithm/byte_swap.hpp"
 #include "perimortem/core/static/bytes.hpp"
 #include "perimortem/core/data.hpp"
+#include "perimortem/core/math.hpp"
 #include "perimortem/core/diagnostics/log.hpp"
 #include "perimortem/core/null_terminated.hpp"
 #include "perimortem/core/writer/textual.hpp"
@@ -14,11 +16,11 @@ using namespace Perimortem::Core;
 auto check_buffer_overruns(Count ptr, Count source_size, Count read_size)
     -> Bool {
   if (ptr + read_size > source_size) [[unlikely]] {
-    Static::Bytes<128> error_buffer;
+    Static::Bytes<256> error_buffer;
     Writer::Textual error_message(error_buffer);
-    error_message << "Binary read over ran buffer at read location "_view << ptr
-                  << ". source_size="_view << source_size << ", read_size="_view
-                  << read_size;
+    error_message.format<
+        "Binary read over ran buffer at read location {}. source_size={}, "
+        "read_size={}">(ptr, source_size, read_size);
     Diagnostics::Log::error(error_message);
     return False;
   }
@@ -27,117 +29,267 @@ auto check_buffer_overruns(Count ptr, Count source_size, Count read_size)
 }
 
 template <Data::ByteOrder endian, typename storage_type>
-static constexpr auto read_value(View::Bytes source, Bool& valid, Count& ptr)
-    -> storage_type {
-  Count base = Count(source.get_data());
-  ptr = Data::align<sizeof(storage_type)>(base + ptr) - base;
-
-  if (!check_buffer_overruns(ptr, source.get_size(), sizeof(storage_type))) {
-    valid = false;
+static constexpr auto read_value(const Bits_8* source) -> storage_type {
+  if (!source) [[unlikely]] {
     return storage_type();
   }
 
   storage_type actual_bytes;
-  memcpy(&actual_bytes, source.get_data() + ptr, sizeof(storage_type));
-  ptr += sizeof(storage_type);
+  memcpy(&actual_bytes, source, sizeof(storage_type));
   return Data::ensure_endian<endian, Data::ByteOrder::Native>(actual_bytes);
 }
 
 // memcpy is actually too smart for it's own good and will try to interpret
 // bytes for floats and reals rather than just loading it as is.
 template <Data::ByteOrder endian, typename storage_type, typename real_type>
-static constexpr auto read_real(View::Bytes source, Bool& valid, Count& ptr)
-    -> real_type {
+static constexpr auto read_real(const Bits_8* source) -> real_type {
   // Make unit tests fail at least on mismatch.
-  if constexpr (sizeof(storage_type) != sizeof(real_type)) {
-    valid = False;
-    return real_type();
-  }
+  static_assert(sizeof(storage_type) == sizeof(real_type));
 
-  Count base = Count(source.get_data());
-  ptr = Data::align<sizeof(storage_type)>(base + ptr) - base;
-
-  if (!check_buffer_overruns(ptr, source.get_size(), sizeof(storage_type))) {
-    valid = False;
+  if (!source) [[unlikely]] {
     return real_type();
   }
 
   storage_type actual_bytes;
-  memcpy(&actual_bytes, source.get_data() + ptr, sizeof(storage_type));
+  memcpy(&actual_bytes, source, sizeof(storage_type));
   actual_bytes =
       Data::ensure_endian<endian, Data::ByteOrder::Native>(actual_bytes);
 
   // Read the bytes in correct memory order into the floating point unit.
-  ptr += sizeof(storage_type);
   return *Data::cast<real_type>(&actual_bytes);
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::set_pointer(Count location) -> void {
-  ptr_location = location < data.get_size() ? location : data.get_size();
+  if (!stream) {
+    ptr_location = location < data.get_size() ? location : data.get_size();
+    return;
+  }
+
+  location = location < stream->get_size() ? location : stream->get_size();
+  if (location >= window_offset &&
+      location <= window_offset + data.get_size()) {
+    ptr_location = location - window_offset;
+    return;
+  }
+
+  // Leave the window empty until the next read asks for it.
+  data = View::Bytes();
+  window_offset = location;
+  ptr_location = 0;
+}
+
+// Aligns the pointer and returns the next `size` bytes, refilling the window
+// from the stream when they run past the end of it.
+template <Data::ByteOrder stream_endian>
+template <Count alignment>
+auto Reader::Binary<stream_endian>::take(Count size) -> const Bits_8* {
+  // Memory buffers align by address, streams by offset from their start.
+  const Count base = stream ? 0 : Count(data.get_data());
+  const Count location =
+      Data::align<alignment>(base + get_location()) - base;
+
+  if (stream && location + size > window_offset + data.get_size()) {
+    if (!check_buffer_overruns(location, stream->get_size(), size)) {
+      ptr_location = location - window_offset;
+      valid_state = False;
+      return nullptr;
+    }
+
+    data = stream->fetch(location, size);
+    window_offset = location;
+  }
+
+  ptr_location = location - window_offset;
+  if (!check_buffer_overruns(ptr_location, data.get_size(), size)) {
+    valid_state = False;
+    return nullptr;
+  }
+
+  const Bits_8* result = data.get_data() + ptr_location;
+  ptr_location += size;
+  return result;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_bits_8() -> Bits_8 {
-  return read_value<stream_endian, Bits_8>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Bits_8>(take<sizeof(Bits_8)>(1));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_bits_16() -> Bits_16 {
-  return read_value<stream_endian, Bits_16>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Bits_16>(take<sizeof(Bits_16)>(2));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_bits_32() -> Bits_32 {
-  return read_value<stream_endian, Bits_32>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Bits_32>(take<sizeof(Bits_32)>(4));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_bits_64() -> Bits_64 {
-  return read_value<stream_endian, Bits_64>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Bits_64>(take<sizeof(Bits_64)>(8));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_signed_bits_8() -> Signed_8 {
-  return read_value<stream_endian, Signed_8>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Signed_8>(take<sizeof(Signed_8)>(1));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_signed_bits_16() -> Signed_16 {
-  return read_value<stream_endian, Signed_16>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Signed_16>(take<sizeof(Signed_16)>(2));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_signed_bits_32() -> Signed_32 {
-  return read_value<stream_endian, Signed_32>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Signed_32>(take<sizeof(Signed_32)>(4));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_signed_bits_64() -> Signed_64 {
-  return read_value<stream_endian, Signed_64>(data, valid_state, ptr_location);
+  return read_value<stream_endian, Signed_64>(take<sizeof(Signed_64)>(8));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_real_32() -> Real_32 {
-  return read_real<stream_endian, Bits_32, Real_32>(
-      data, valid_state, ptr_location);
+  return read_real<stream_endian, Bits_32, Real_32>(take<sizeof(Bits_32)>(4));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_real_64() -> Real_64 {
-  return read_real<stream_endian, Bits_64, Real_64>(
-      data, valid_state, ptr_location);
+  return read_real<stream_endian, Bits_64, Real_64>(take<sizeof(Bits_64)>(8));
 }
 
 template <Data::ByteOrder stream_endian>
 auto Reader::Binary<stream_endian>::read_bytes(Count count) -> View::Bytes {
-  if (!check_buffer_overruns(ptr_location, data.get_size(), count)) {
+  const Bits_8* bytes = take<1>(count);
+  if (!bytes) [[unlikely]] {
+    // Hand back whatever was left, the same as a plain buffer.
+    View::Bytes result = data.slice(ptr_location, count);
+    ptr_location += count;
+    return result;
+  }
+
+  return View::Bytes(bytes, count);
+}
+
+// Copies out whole elements a window at a time, swapping the bytes of each
+// when the stream isn't in native order.
+template <Data::ByteOrder stream_endian>
+template <typename element_type>
+auto Reader::Binary<stream_endian>::read_elements(
+    Access::Vector<element_type> values) -> Bool {
+  constexpr Count width = sizeof(element_type);
+  Bits_8* target = Data::cast<Bits_8>(values.get_data());
+  Count remaining = values.get_size() * width;
+
+  // Check the whole array fits up front so a failure doesn't leave it half
+  // read.
+  const Count base = stream ? 0 : Count(data.get_data());
+  const Count location = Data::align<width>(base + get_location()) - base;
+  if (!check_buffer_overruns(location, get_size(), remaining)) [[unlikely]] {
+    for (Count i = 0; i < values.get_size(); i++) {
+      values[i] = element_type();
+    }
+
+    set_pointer(location);
     valid_state = False;
+    return False;
   }
 
-  View::Bytes result = data.slice(ptr_location, count);
-  ptr_location += count;
-  return result;
+  set_pointer(location);
+  while (remaining > 0) {
+    Count available = ptr_location < data.get_size()
+                          ? data.get_size() - ptr_location
+                          : 0;
+    if (available < width) {
+      data = stream->fetch(get_location(), remaining);
+      window_offset += ptr_location;
+      ptr_location = 0;
+      available = data.get_size();
+
+      // Only a window smaller than one element can get stuck here.
+      if (available < width) [[unlikely]] {
+        valid_state = False;
+        return False;
+      }
+    }
+
+    const Count size = Math::min(available - available % width, remaining);
+    const Bits_8* source = data.get_data() + ptr_location;
+    if constexpr (width == 1 || stream_endian == Data::ByteOrder::Native) {
+      Data::copy(target, source, size);
+    } else {
+      Algorithm::copy_swapped<width>(target, source, size / width);
+    }
+
+    target += size;
+    ptr_location += size;
+    remaining -= size;
+  }
+
+  return True;
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Bits_8> values)
+    -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Bits_16> values)
+    -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Bits_32> values)
+    -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Bits_64> values)
+    -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(
+    Access::Vector<Signed_8> values) -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(
+    Access::Vector<Signed_16> values) -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(
+    Access::Vector<Signed_32> values) -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(
+    Access::Vector<Signed_64> values) -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Real_32> values)
+    -> Bool {
+  return read_elements(values);
+}
+
+template <Data::ByteOrder stream_endian>
+auto Reader::Binary<stream_endian>::read_array(Access::Vector<Real_64> values)
+    -> Bool {
+  return read_elements(values);
 }
 
 // Instantiate the two binary readers.
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "perimortem/core/access/vector.hpp"
 #include "perimortem/core/view/bytes.hpp"
 #include "perimortem/core/data.hpp"
+#include "perimortem/core/reader/stream.hpp"
 
 namespace Perimortem::Core::Reader {
 
@@ -17,6 +19,10 @@ namespace Perimortem::Core::Reader {
 // arbitrary location, however it does not convert the bytes into Native endian
 // and simply returns a View.
 //
+// When reading through a Stream, locations are offsets into the whole stream
+// and alignment is measured from its first byte. Views from read_bytes() are
+// only valid until the next read and can't be larger than the stream's window.
+//
 // On overflow or any failed read the reader enters an invalid state and all
 // subsequent reads return zero-initialized values without advancing the
 // pointer.
@@ -24,7 +30,9 @@ template <Data::ByteOrder stream_endian>
 class Binary {
  public:
   constexpr Binary(View::Bytes source) : data(source) {}
-  constexpr Binary(const Binary& rhs) : data(rhs.data) {}
+  constexpr Binary(Stream& source) : stream(&source) {}
+  constexpr Binary(const Binary& rhs)
+      : data(rhs.data), stream(rhs.stream), window_offset(rhs.window_offset) {}
 
   // Sets the location of the read pointer.
   // If the index is out of range the pointer is put to the end of the buffer.
@@ -42,19 +50,45 @@ class Binary {
   auto read_real_64() -> Real_64;
   auto read_bytes(Count count) -> View::Bytes;
 
-  constexpr auto get_size() const -> Count { return data.get_size(); }
-  constexpr auto get_location() const -> Count { return ptr_location; }
-  constexpr auto is_valid() const -> Bool { return valid_state; }
-  constexpr auto is_empty() const -> Bool {
-    return get_location() == get_size();
+  // Fills `values` from a packed array aligned like its first element,
+  // checking bounds once for the whole array and converting endian in bulk.
+  // On failure `values` is zeroed and the reader is left invalid.
+  // Streams are read through in window sized pieces so the array can be
+  // larger than the window.
+  auto read_array(Access::Vector<Bits_8> values) -> Bool;
+  auto read_array(Access::Vector<Bits_16> values) -> Bool;
+  auto read_array(Access::Vector<Bits_32> values) -> Bool;
+  auto read_array(Access::Vector<Bits_64> values) -> Bool;
+  auto read_array(Access::Vector<Signed_8> values) -> Bool;
+  auto read_array(Access::Vector<Signed_16> values) -> Bool;
+  auto read_array(Access::Vector<Signed_32> values) -> Bool;
+  auto read_array(Access::Vector<Signed_64> values) -> Bool;
+  auto read_array(Access::Vector<Real_32> values) -> Bool;
+  auto read_array(Access::Vector<Real_64> values) -> Bool;
+
+  auto get_size() const -> Count {
+    return stream ? stream->get_size() : data.get_size();
   }
-  constexpr auto reset() -> void {
+  constexpr auto get_location() const -> Count {
+    return window_offset + ptr_location;
+  }
+  constexpr auto is_valid() const -> Bool { return valid_state; }
+  auto is_empty() const -> Bool { return get_location() == get_size(); }
+  auto reset() -> void {
     valid_state = true;
-    ptr_location = 0;
+    set_pointer(0);
   }
 
  private:
+  template <Count alignment>
+  auto take(Count size) -> const Bits_8*;
+  template <typename element_type>
+  auto read_elements(Access::Vector<element_type> values) -> Bool;
+
+  // The whole source, or the current window of the stream.
   View::Bytes data;
+  Stream* stream = nullptr;
+  Count window_offset = 0;
   Count ptr_location = 0;
   Bool valid_state = True;
 };
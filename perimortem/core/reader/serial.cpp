@@ -18,16 +18,48 @@ constexpr auto negate_flag = 0x10;
 constexpr auto blob_flag = 0x20;
 
 auto Reader::Serial::set_pointer(Count location) -> void {
-  ptr_location = location < data.get_size() ? location : data.get_size();
+  if (!stream) {
+    ptr_location = location < data.get_size() ? location : data.get_size();
+    return;
+  }
+
+  location = location < stream->get_size() ? location : stream->get_size();
+  if (location >= window_offset &&
+      location <= window_offset + data.get_size()) {
+    ptr_location = location - window_offset;
+    return;
+  }
+
+  // Leave the window empty until the next read asks for it.
+  data = View::Bytes();
+  window_offset = location;
+  ptr_location = 0;
+}
+
+// Makes sure the next `size` bytes are in the window, moving the window up to
+// the read pointer when reading through a stream.
+auto Reader::Serial::request(Count size) -> Bool {
+  if (ptr_location + size <= data.get_size()) {
+    return True;
+  }
+
+  if (!stream || get_location() + size > stream->get_size()) {
+    return False;
+  }
+
+  window_offset += ptr_location;
+  ptr_location = 0;
+  data = stream->fetch(window_offset, size);
+  return size <= data.get_size();
 }
 
 auto Reader::Serial::read() -> Value {
-  if (!valid_state || ptr_location >= data.get_size()) {
-    Static::Bytes<128> error_buffer;
+  if (!valid_state || !request(1)) {
+    Static::Bytes<256> error_buffer;
     Writer::Textual error_message(error_buffer);
-    error_message
-        << "Serial read overran data buffer while reading type at byte location "_view
-        << ptr_location << ". source_size="_view << data.get_size();
+    error_message.format<
+        "Serial read overran data buffer while reading type at byte location "
+        "{}. source_size={}">(get_location(), get_size());
     Diagnostics::Log::error(error_message);
 
     // Set to invalid
@@ -35,17 +67,16 @@ auto Reader::Serial::read() -> Value {
     return Value();
   }
 
-  auto source = data.get_data();
-  auto byte_flag = source[ptr_location++];
+  auto byte_flag = data.get_data()[ptr_location++];
   Bits_8 encoded_size = byte_flag & 0xF;
 
-  if (ptr_location + encoded_size > data.get_size()) {
-    Static::Bytes<128> error_buffer;
+  if (!request(encoded_size)) {
+    Static::Bytes<256> error_buffer;
     Writer::Textual error_message(error_buffer);
-    error_message
-        << "Serial read overran data buffer while reading value at byte location "_view
-        << ptr_location << ". source_size="_view << data.get_size()
-        << " encoded_size="_view << encoded_size;
+    error_message.format<
+        "Serial read overran data buffer while reading value at byte location "
+        "{}. source_size={} encoded_size={}">(
+        get_location(), get_size(), encoded_size);
     Diagnostics::Log::error(error_message);
 
     // Set to invalid
@@ -53,6 +84,7 @@ auto Reader::Serial::read() -> Value {
     return Value();
   }
 
+  auto source = data.get_data();
   Signed_64 value;
   switch (encoded_size) {
   case 1:
@@ -75,11 +107,11 @@ auto Reader::Serial::read() -> Value {
     value = Data::ensure_endian<stream_endian, native_endian>(value);
     break;
   default: {
-    Static::Bytes<128> error_buffer;
+    Static::Bytes<256> error_buffer;
     Writer::Textual error_message(error_buffer);
-    error_message << "Serial read found invalid encoding size "_view
-                  << (encoded_size) << " at byte location "_view << ptr_location
-                  << "."_view;
+    error_message.format<
+        "Serial read found invalid encoding size {} at byte location {}.">(
+        encoded_size, get_location());
     Diagnostics::Log::error(error_message);
 
     // Set to invalid
@@ -101,13 +133,13 @@ auto Reader::Serial::read() -> Value {
     return Value(value);
   }
 
-  if (ptr_location + value > data.get_size()) {
-    Static::Bytes<128> error_buffer;
+  if (!request(value)) {
+    Static::Bytes<256> error_buffer;
     Writer::Textual error_message(error_buffer);
-    error_message << "Serial read of blob sized "_view << value
-                  << " bytes overran source buffer at location "_view
-                  << ptr_location << ". source_size="_view << data.get_size()
-                  << " blob_size="_view << value;
+    error_message.format<
+        "Serial read of blob sized {} bytes overran source buffer at location "
+        "{}. source_size={} blob_size={}">(
+        value, get_location(), get_size(), value);
     Diagnostics::Log::error(error_message);
 
     // Set to invalid
@@ -116,7 +148,7 @@ auto Reader::Serial::read() -> Value {
   }
 
   // Bump the pointer to include the blob as well.
-  auto blob_ptr = source + ptr_location;
+  auto blob_ptr = data.get_data() + ptr_location;
   ptr_location += value;
   return View::Bytes(blob_ptr, value);
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/reader/stream.hpp"
 
 namespace Perimortem::Core::Reader {
 
@@ -19,6 +20,9 @@ namespace Perimortem::Core::Reader {
 // Negative Values are encoded as their two's complement for easier compression
 // with their type byte marked with the negate flag.
 //
+// When reading through a Stream, blobs are views into the current window so
+// they're only valid until the next read and can't be larger than the window.
+//
 // On any error the reader enters an invalid state and all subsequent reads
 // return zero-initialized values without advancing the pointer.
 class Serial {
@@ -65,7 +69,9 @@ class Serial {
   };
 
   constexpr Serial(View::Bytes source) : data(source) {}
-  constexpr Serial(const Serial& rhs) : data(rhs.data) {}
+  constexpr Serial(Stream& source) : stream(&source) {}
+  constexpr Serial(const Serial& rhs)
+      : data(rhs.data), stream(rhs.stream), window_offset(rhs.window_offset) {}
 
   // Sets the location of the read pointer.
   // If the index is out of range the pointer is put to the end of the buffer.
@@ -82,19 +88,26 @@ class Serial {
   // returned.
   auto read_blob() -> View::Bytes;
 
-  constexpr auto get_size() const -> Count { return data.get_size(); }
-  constexpr auto get_location() const -> Count { return ptr_location; }
-  constexpr auto is_valid() const -> Bool { return valid_state; }
-  constexpr auto is_empty() const -> Bool {
-    return get_location() == get_size();
+  auto get_size() const -> Count {
+    return stream ? stream->get_size() : data.get_size();
+  }
+  constexpr auto get_location() const -> Count {
+    return window_offset + ptr_location;
   }
-  constexpr auto reset() -> void {
+  constexpr auto is_valid() const -> Bool { return valid_state; }
+  auto is_empty() const -> Bool { return get_location() == get_size(); }
+  auto reset() -> void {
     valid_state = true;
-    ptr_location = 0;
+    set_pointer(0);
   }
 
  private:
+  auto request(Count size) -> Bool;
+
+  // The whole source, or the current window of the stream.
   View::Bytes data;
+  Stream* stream = nullptr;
+  Count window_offset = 0;
   Count ptr_location = 0;
   Bool valid_state = True;
 };
@@ -0,0 +1,32 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+
+namespace Perimortem::Core::Reader {
+
+// A source of bytes too big (or too slow) to hold in memory all at once.
+//
+// Readers built over a stream work through a window of it at a time and ask
+// for the next window when a read runs past the end of the current one, so
+// memory use is bounded by the window size rather than the size of the data.
+//
+// Refilling a window reuses the stream's storage, so any view handed out
+// from an earlier window is only valid until the next fetch. Readers sharing
+// one stream have to be used one after the other rather than interleaved.
+class Stream {
+ public:
+  virtual ~Stream() = default;
+
+  // Returns a view of the stream starting at `offset` that holds at least
+  // `minimum` bytes, or fewer if the stream ends first or the request is
+  // larger than the stream can hold at once.
+  virtual auto fetch(Count offset, Count minimum) -> View::Bytes = 0;
+
+  // Total size of the stream in bytes.
+  virtual auto get_size() const -> Count = 0;
+};
+
+}  // namespace Perimortem::Core::Reader
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "perimortem/core/access/vector.hpp"
 #include "perimortem/core/view/bytes.hpp"
 
 namespace Perimortem::Core::Reader {
@@ -14,6 +15,9 @@ namespace Perimortem::Core::Reader {
 // read_byte() which never skips whitespace and always consume exactly one byte
 // from the current position.
 //
+// Reals are parsed exactly, accepting exponents and any number of digits, so
+// anything written by Writer::Textual reads back as the same value.
+//
 // On overflow or a parse failure the reader enters an invalid state and
 // subsequent reads return zero-initialized values without advancing the
 // pointer.
@@ -33,6 +37,14 @@ class Textual {
   auto read_real_32() -> Real_32;
   auto read_real_64() -> Real_64;
 
+  // Fills `values` from a list of numbers separated by whitespace and/or
+  // commas, stopping early at the end of the text or the first byte that
+  // can't start a number (like the ']' closing an array). Returns how many
+  // were read.
+  auto read_array(Access::Vector<Bits_64> values) -> Count;
+  auto read_array(Access::Vector<Signed_64> values) -> Count;
+  auto read_array(Access::Vector<Real_64> values) -> Count;
+
   constexpr auto get_size() const -> Count { return data.get_size(); }
   constexpr auto get_location() const -> Count { return ptr_location; }
   constexpr auto is_valid() const -> Bool { return valid_state; }
@@ -46,7 +58,9 @@ class Textual {
 
  private:
   auto skip_whitespace() -> void;
-  auto read_real() -> Real_64;
+  auto skip_separators(Bool allow_words) -> Bool;
+  template <typename real_type>
+  auto read_real() -> real_type;
   View::Bytes data;
   Count ptr_location = 0;
   Bool valid_state = True;
@@ -0,0 +1,68 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include <x86intrin.h>
+
+#include "perimortem/core/perimortem.hpp"
+
+namespace Perimortem::Core::Thread {
+
+// Reader-writer spin lock for short critical sections.
+//
+// Readers don't exclude each other, but each shared acquire and release is an
+// atomic add on the lock word, so concurrent readers still bounce its cache
+// line between cores and this isn't lock free. Readers spin while a writer
+// holds the lock. A writer claims the writer bit before waiting for readers to
+// drain so new readers back off instead of starving it. The whole lock is 4
+// bytes so it can share a cache line with the data it protects.
+//
+// Anything that can block for a while (IO, allocation heavy work) should use a
+// pthread mutex instead since waiters here burn their core.
+class SharedSpinLock {
+ public:
+  auto lock_shared() const -> void {
+    while (true) {
+      const auto state = __atomic_add_fetch(&word, 1, __ATOMIC_ACQUIRE);
+      if (!(state & writer_bit)) [[likely]] {
+        return;
+      }
+
+      // Back out and wait for the writer to finish.
+      __atomic_sub_fetch(&word, 1, __ATOMIC_RELAXED);
+      while (__atomic_load_n(&word, __ATOMIC_RELAXED) & writer_bit) {
+        _mm_pause();
+      }
+    }
+  }
+
+  auto unlock_shared() const -> void {
+    __atomic_sub_fetch(&word, 1, __ATOMIC_RELEASE);
+  }
+
+  auto lock() -> void {
+    // Only one writer can own the writer bit at a time.
+    while (__atomic_fetch_or(&word, writer_bit, __ATOMIC_ACQUIRE) &
+           writer_bit) {
+      while (__atomic_load_n(&word, __ATOMIC_RELAXED) & writer_bit) {
+        _mm_pause();
+      }
+    }
+
+    // Wait for any readers that got in before us.
+    while (__atomic_load_n(&word, __ATOMIC_ACQUIRE) != writer_bit) {
+      _mm_pause();
+    }
+  }
+
+  auto unlock() -> void {
+    __atomic_and_fetch(&word, ~writer_bit, __ATOMIC_RELEASE);
+  }
+
+ private:
+  static constexpr Bits_32 writer_bit = Bits_32(1) << 31;
+  mutable Bits_32 word = 0;
+};
+
+}  // namespace Perimortem::Core::Thread
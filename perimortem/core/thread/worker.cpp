@@ -113,10 +113,9 @@ auto Thread::Worker::start(Core::View::Bytes name, JobFunc func)
   if (target_info.name_size > target_info.name.get_capacity() - 1) {
     Static::Bytes<256> buffer;
     Writer::Textual warning_message(buffer);
-    warning_message << "Requested thread name `"_view << name
-                    << "` is too long and will be shortened to `"_view
-                    << name.slice(0, target_info.name.get_capacity() - 1)
-                    << "`"_view;
+    warning_message.format<
+        "Requested thread name `{}` is too long and will be shortened to `{}`">(
+        name, name.slice(0, target_info.name.get_capacity() - 1));
     Diagnostics::Log::warning(warning_message);
     target_info.name_size = target_info.name.get_capacity() - 1;
   }
@@ -3,6 +3,7 @@
 
 #include "perimortem/core/writer/binary.hpp"
 
+#include "perimortem/core/algorithm/byte_swap.hpp"
 #include "perimortem/core/data.hpp"
 
 using namespace Perimortem::Core;
@@ -10,13 +11,22 @@ using namespace Perimortem::Core;
 // write_value and write_vector are local template helpers so the member
 // implementations can stay in this .cpp file without leaking into the header.
 
+// Sinks can move their storage as they grow, so alignment is measured from the
+// start of the sink rather than by address.
+static constexpr auto base_address(Access::Bytes target, Writer::Sink* sink)
+    -> Count {
+  return sink ? 0 : Count(target.get_data());
+}
+
 template <Data::ByteOrder endian, typename storage_type>
-static constexpr auto
-    write_value(Access::Bytes target, Count& ptr, storage_type val) -> Bool {
-  Count base = Count(target.get_data());
+static constexpr auto write_value(
+    Access::Bytes& target, Writer::Sink* sink, Count& ptr, storage_type val)
+    -> Bool {
+  Count base = base_address(target, sink);
   ptr = Data::align<sizeof(storage_type)>(base + ptr) - base;
 
-  if (ptr + sizeof(storage_type) > target.get_size()) [[unlikely]] {
+  if (!Writer::reserve(target, sink, ptr + sizeof(storage_type)))
+      [[unlikely]] {
     return False;
   }
 
@@ -29,17 +39,19 @@ static constexpr auto
 // memcpy is actually too smart for it's own good and will try to interpret
 // bytes for floats and reals rather than just loading it as is.
 template <Data::ByteOrder endian, typename storage_type, typename real_type>
-static constexpr auto
-    write_real(Access::Bytes target, Count& ptr, real_type val)
-        -> Bool {  // Make unit tests fail at least on mismatch.
+static constexpr auto write_real(
+    Access::Bytes& target, Writer::Sink* sink, Count& ptr, real_type val)
+    -> Bool {
+  // Make unit tests fail at least on mismatch.
   if constexpr (sizeof(storage_type) != sizeof(real_type)) {
     return False;
   }
 
-  Count base = Count(target.get_data());
+  Count base = base_address(target, sink);
   ptr = Data::align<sizeof(storage_type)>(base + ptr) - base;
 
-  if (ptr + sizeof(storage_type) > target.get_size()) [[unlikely]] {
+  if (!Writer::reserve(target, sink, ptr + sizeof(storage_type)))
+      [[unlikely]] {
     return False;
   }
 
@@ -52,31 +64,30 @@ static constexpr auto
 }
 
 template <Data::ByteOrder endian, typename blob_type>
-static constexpr auto
-    write_vector(Access::Bytes target, Count& ptr, blob_type blob) -> Bool {
+static constexpr auto write_vector(
+    Access::Bytes& target, Writer::Sink* sink, Count& ptr, blob_type blob)
+    -> Bool {
   using element_type = typename blob_type::data_type;
-  Count base = Count(target.get_data());
+  Count base = base_address(target, sink);
   ptr = Data::align<sizeof(element_type)>(base + ptr) - base;
 
   Count total = sizeof(element_type) * blob.get_size();
-  if (ptr + total > target.get_size()) [[unlikely]] {
+  if (!Writer::reserve(target, sink, ptr + total)) [[unlikely]] {
     return False;
   }
 
-  // Optimize for View::Bytes and when writing in the native endianness.
+  // Optimize for View::Bytes and when writing in the native endianness,
+  // otherwise swap the whole array in one pass.
   if constexpr (
       sizeof(element_type) == 1 || Data::ByteOrder::Native == endian) {
     Data::copy(target.get_data() + ptr, blob.get_data(), blob.get_size());
-    ptr += total;
   } else {
-    for (Count index = 0; index < blob.get_size(); index++) {
-      element_type element =
-          Data::ensure_endian<Data::ByteOrder::Native, endian>(
-              blob.get_data()[index]);
-      Data::copy(target.get_data() + ptr, &element);
-      ptr += sizeof(element_type);
-    }
+    Algorithm::copy_swapped<sizeof(element_type)>(
+        target.get_data() + ptr, Data::cast<const Bits_8>(blob.get_data()),
+        blob.get_size());
   }
+
+  ptr += total;
   return True;
 }
 
@@ -87,68 +98,71 @@ auto Writer::Binary<stream_endian>::set_pointer(Count location) -> void {
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Bits_8 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Bits_16 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Bits_32 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Bits_64 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Signed_8 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Signed_16 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Signed_32 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Signed_64 bin) -> Binary& {
-  valid_state &= write_value<stream_endian>(data, ptr_location, bin);
+  valid_state &= write_value<stream_endian>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Real_32 bin) -> Binary& {
-  valid_state &= write_real<stream_endian, Bits_32>(data, ptr_location, bin);
+  valid_state &=
+      write_real<stream_endian, Bits_32>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const Real_64 bin) -> Binary& {
-  valid_state &= write_real<stream_endian, Bits_64>(data, ptr_location, bin);
+  valid_state &=
+      write_real<stream_endian, Bits_64>(data, sink, ptr_location, bin);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const View::Bytes raw)
     -> Binary& {
-  if (ptr_location + raw.get_size() > data.get_size()) [[unlikely]] {
+  if (!Writer::reserve(data, sink, ptr_location + raw.get_size()))
+      [[unlikely]] {
     valid_state = False;
     return *this;
   }
@@ -160,56 +174,70 @@ auto Writer::Binary<stream_endian>::operator<<(const View::Bytes raw)
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Bits_8> blob)
     -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Bits_16> blob)
     -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Bits_32> blob)
     -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Bits_64> blob)
     -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(
     const View::Vector<Signed_8> blob) -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(
     const View::Vector<Signed_16> blob) -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(
     const View::Vector<Signed_32> blob) -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
 template <Data::ByteOrder stream_endian>
 auto Writer::Binary<stream_endian>::operator<<(
     const View::Vector<Signed_64> blob) -> Binary& {
-  valid_state &= write_vector<stream_endian>(data, ptr_location, blob);
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
+  return *this;
+}
+
+template <Data::ByteOrder stream_endian>
+auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Real_32> blob)
+    -> Binary& {
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
+  return *this;
+}
+
+template <Data::ByteOrder stream_endian>
+auto Writer::Binary<stream_endian>::operator<<(const View::Vector<Real_64> blob)
+    -> Binary& {
+  valid_state &= write_vector<stream_endian>(data, sink, ptr_location, blob);
   return *this;
 }
 
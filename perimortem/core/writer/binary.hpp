@@ -7,6 +7,7 @@
 #include "perimortem/core/view/vector.hpp"
 #include "perimortem/core/access/bytes.hpp"
 #include "perimortem/core/data.hpp"
+#include "perimortem/core/writer/sink.hpp"
 
 namespace Perimortem::Core::Writer {
 
@@ -19,13 +20,21 @@ namespace Perimortem::Core::Writer {
 // arbitrary location, however it does not convert the bytes into Native endian
 // and simply returns a View.
 //
+// Vectors are written as packed arrays aligned like their first element,
+// checked against the buffer once and converted to the stream endian in bulk.
+//
+// Writing into a Sink grows it as needed instead of overflowing, with alignment
+// measured from the start of the sink. The sink may end up larger than what
+// was written, so trim it to get_location() after.
+//
 // On overflow the writer enters an invalid state and subsequent writes are safe
 // but treated as undefined behavior.
 template <Data::ByteOrder stream_endian>
 class Binary {
  public:
   constexpr Binary(Core::Access::Bytes data) : data(data) {};
-  constexpr Binary(const Binary& rhs) : data(rhs.data) {};
+  constexpr Binary(Sink& target) : sink(&target) {};
+  constexpr Binary(const Binary& rhs) : data(rhs.data), sink(rhs.sink) {};
 
   // Sets the location of the read/write pointer.
   // If the index is out of range then the pointer is put to the end of the
@@ -51,6 +60,8 @@ class Binary {
   auto operator<<(const View::Vector<Signed_16> blob) -> Binary&;
   auto operator<<(const View::Vector<Signed_32> blob) -> Binary&;
   auto operator<<(const View::Vector<Signed_64> blob) -> Binary&;
+  auto operator<<(const View::Vector<Real_32> blob) -> Binary&;
+  auto operator<<(const View::Vector<Real_64> blob) -> Binary&;
 
   constexpr auto get_size() const -> Count { return data.get_size(); }
   constexpr auto get_location() const -> Count { return ptr_location; }
@@ -61,6 +72,7 @@ class Binary {
 
  private:
   Access::Bytes data;
+  Sink* sink = nullptr;
   Count ptr_location = 0;
   Bool valid_state = True;
 };
@@ -14,7 +14,8 @@ constexpr auto negate_flag = 0x10;
 constexpr auto blob_flag = 0x20;
 
 constexpr auto write_value(
-    Access::Bytes target,
+    Access::Bytes& target,
+    Writer::Sink* sink,
     Count& ptr_location,
     Signed_64 value,
     Bits_8 flags) -> Bool {
@@ -35,7 +36,8 @@ constexpr auto write_value(
     encoding_size = 4;
   }
 
-  if (ptr_location + 1 + encoding_size > target.get_size()) [[unlikely]] {
+  if (!Writer::reserve(target, sink, ptr_location + 1 + encoding_size))
+      [[unlikely]] {
     return False;
   }
 
@@ -67,14 +69,16 @@ constexpr auto write_value(
 }
 
 constexpr auto write_blob(
-    Access::Bytes target,
+    Access::Bytes& target,
+    Writer::Sink* sink,
     Count& ptr_location,
     View::Bytes source) -> Bool {
-  if (!write_value(target, ptr_location, source.get_size(), blob_flag)) {
+  if (!write_value(
+          target, sink, ptr_location, source.get_size(), blob_flag)) {
     return False;
   }
 
-  if (ptr_location + source.get_size() > target.get_size()) {
+  if (!Writer::reserve(target, sink, ptr_location + source.get_size())) {
     return False;
   }
 
@@ -89,12 +93,24 @@ auto Writer::Serial::set_pointer(Count location) -> void {
 }
 
 auto Writer::Serial::operator<<(const Bits_64 bin) -> Writer::Serial& {
-  valid_state &= write_value(data, ptr_location, bin, 0x00);
+  valid_state &= write_value(data, sink, ptr_location, bin, 0x00);
   return *this;
 }
 
 auto Writer::Serial::operator<<(const View::Bytes blob) -> Writer::Serial& {
   // Write type information
-  valid_state &= write_blob(data, ptr_location, blob);
+  valid_state &= write_blob(data, sink, ptr_location, blob);
   return *this;
 }
+
+auto Writer::Serial::reserve_blob(Count size) -> Access::Bytes {
+  valid_state &= write_value(data, sink, ptr_location, size, blob_flag);
+  valid_state &= Writer::reserve(data, sink, ptr_location + size);
+  if (!valid_state) {
+    return Access::Bytes();
+  }
+
+  auto blob = data.slice(ptr_location, size);
+  ptr_location += size;
+  return blob;
+}
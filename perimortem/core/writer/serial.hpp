@@ -7,6 +7,7 @@
 #include "perimortem/core/view/vector.hpp"
 #include "perimortem/core/access/bytes.hpp"
 #include "perimortem/core/data.hpp"
+#include "perimortem/core/writer/sink.hpp"
 
 namespace Perimortem::Core::Writer {
 
@@ -22,18 +23,27 @@ namespace Perimortem::Core::Writer {
 // Negative Values are encoded as their two's complement for easier compression
 // with their type byte marked with the negate flag.
 //
+// Writing into a Sink grows it as needed instead of overflowing. The sink may
+// end up larger than what was written, so trim it to get_location() after.
+//
 // On overflow the writer enters an invalid state and subsequent writes are safe
 // but treated as undefined behavior.
 class Serial {
  public:
   constexpr Serial(Access::Bytes data) : data(data) {};
-  constexpr Serial(const Serial& rhs) : data(rhs.data) {};
+  constexpr Serial(Sink& target) : sink(&target) {};
+  constexpr Serial(const Serial& rhs) : data(rhs.data), sink(rhs.sink) {};
 
   auto set_pointer(Count location) -> void;
 
   auto operator<<(const Bits_64 value) -> Serial&;
   auto operator<<(const View::Bytes blob) -> Serial&;
 
+  // Writes the header for a blob of `size` bytes and hands back the space for
+  // its contents so they can be encoded in place. Returns an empty Access on
+  // overflow.
+  auto reserve_blob(Count size) -> Access::Bytes;
+
   constexpr auto get_size() const -> Count { return data.get_size(); }
   constexpr auto get_location() const -> Count { return ptr_location; }
   constexpr auto is_valid() const -> Bool { return valid_state; }
@@ -43,6 +53,7 @@ class Serial {
 
  private:
   Access::Bytes data;
+  Sink* sink = nullptr;
   Count ptr_location = 0;
   Bool valid_state = True;
 };
@@ -0,0 +1,41 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/access/bytes.hpp"
+
+namespace Perimortem::Core::Writer {
+
+// Storage a writer can grow into rather than going invalid when it runs out of
+// room, so output doesn't need to be sized up front.
+//
+// Growing can move the storage, so anything pointing into the old buffer is
+// stale after a write that grows it. Writers sharing one sink have to be used
+// one after the other rather than interleaved.
+class Sink {
+ public:
+  virtual ~Sink() = default;
+
+  // Returns storage holding at least `required` bytes that starts with
+  // everything written so far. Returning less than `required` fails the write.
+  virtual auto grow(Count required) -> Access::Bytes = 0;
+};
+
+// Makes sure `data` holds at least `required` bytes, growing it through
+// `sink` when there is one. The common case of already having room is kept
+// inline so writers only pay for the call when they actually grow.
+constexpr auto reserve(Access::Bytes& data, Sink* sink, Count required) -> Bool {
+  if (required <= data.get_size()) [[likely]] {
+    return True;
+  }
+
+  if (!sink) {
+    return False;
+  }
+
+  data = sink->grow(required);
+  return required <= data.get_size();
+}
+
+}  // namespace Perimortem::Core::Writer
@@ -4,10 +4,79 @@
 #pragma once
 
 #include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/view/vector.hpp"
 #include "perimortem/core/access/bytes.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/writer/sink.hpp"
 
 namespace Perimortem::Core::Writer {
 
+// A Textual::format pattern split around its `{}` placeholders at compile
+// time, with `{{` and `}}` already collapsed to single braces.
+template <NullTerminated::CString pattern>
+struct FormatPattern {
+  struct Shape {
+    Count text_size = 0;
+    Count placeholder_count = 0;
+    Bool valid = True;
+  };
+
+  // Walks the pattern, optionally filling in the literal text and where each
+  // segment of it ends.
+  static constexpr auto scan(Bits_8* text, Count* ends) -> Shape {
+    Shape shape;
+    const Count size = pattern.get_size();
+    for (Count i = 0; i < size; i++) {
+      const Bits_8 letter = pattern.content[i];
+      const Bits_8 next = i + 1 < size ? pattern.content[i + 1] : 0;
+      if (letter == '{' && next == '}') {
+        if (ends) {
+          ends[shape.placeholder_count] = shape.text_size;
+        }
+        shape.placeholder_count++;
+        i++;
+        continue;
+      }
+
+      if (letter == '{' || letter == '}') {
+        if (next != letter) {
+          shape.valid = False;
+        }
+        i++;
+      }
+
+      if (text) {
+        text[shape.text_size] = letter;
+      }
+      shape.text_size++;
+    }
+
+    if (ends) {
+      ends[shape.placeholder_count] = shape.text_size;
+    }
+    return shape;
+  }
+
+  static constexpr Shape shape = scan(nullptr, nullptr);
+
+  struct Segments {
+    // One byte over so an empty pattern still has an array.
+    Bits_8 text[shape.text_size + 1]{};
+    Count ends[shape.placeholder_count + 1]{};
+  };
+
+  static constexpr Segments segments = [] {
+    Segments result;
+    scan(result.text, result.ends);
+    return result;
+  }();
+
+  static constexpr auto get_segment(Count index) -> View::Bytes {
+    const Count start = index ? segments.ends[index - 1] : 0;
+    return View::Bytes(segments.text + start, segments.ends[index] - start);
+  }
+};
+
 // Reads human-readable values from a text byte buffer. Reads are greedy so
 // numeric values must be whitespace seperated to be read appropriately.
 //
@@ -15,12 +84,16 @@ namespace Perimortem::Core::Writer {
 // read_byte() which never skips whitespace and always consume exactly one byte
 // from the current position.
 //
+// Writing into a Sink grows it as needed instead of overflowing. The sink may
+// end up larger than what was written, so trim it to get_location() after.
+//
 // On overflow the writer enters an invalid state and subsequent writes are safe
 // but treated as undefined behavior.
 class Textual {
  public:
   Textual(Core::Access::Bytes source) : data(source) {};
-  Textual(const Textual& rhs) : data(rhs.data) {};
+  Textual(Sink& target) : sink(&target) {};
+  Textual(const Textual& rhs) : data(rhs.data), sink(rhs.sink) {};
 
   // Sets the location of the read/write pointer.
   // If the index is out of range then the pointer is put to the end of the
@@ -40,6 +113,25 @@ class Textual {
   auto operator<<(const Real_64 value) -> Textual&;
   auto operator<<(const View::Bytes raw) -> Textual&;
 
+  // Writes `pattern` with each `{}` replaced by the next argument, formatted
+  // the same as operator<<. Use `{{` and `}}` for literal braces.
+  //
+  // The pattern is split up at compile time and room for the longest possible
+  // result is reserved with a single check, after which the pieces are written
+  // without any further bounds checks. If that much room isn't available it
+  // falls back to writing piece by piece, as a shorter result may still fit.
+  template <NullTerminated::CString pattern, typename... argument_types>
+  auto format(const argument_types&... arguments) -> Textual&;
+
+  // Writes every value with `separator` between them, like ", " for a list or
+  // "," for a JSON array body.
+  auto write_array(View::Vector<Bits_64> values, View::Bytes separator)
+      -> Textual&;
+  auto write_array(View::Vector<Signed_64> values, View::Bytes separator)
+      -> Textual&;
+  auto write_array(View::Vector<Real_64> values, View::Bytes separator)
+      -> Textual&;
+
   constexpr auto get_size() const -> Count { return data.get_size(); }
   constexpr auto get_location() const -> Count { return ptr_location; }
   constexpr auto is_valid() const -> Bool { return valid_state; }
@@ -48,10 +140,84 @@ class Textual {
   }
 
  private:
-  auto write_real(Real_64 real, Real_64 precision) -> void;
+  // Longest text operator<< writes for a real.
+  static constexpr Count max_real_length = 32;
+
+  template <typename real_type>
+  auto write_real(real_type real) -> void;
+
+  // Upper bounds on the text operator<< writes for each type.
+  static constexpr auto max_length(const Bool) -> Count { return 5; }
+  static constexpr auto max_length(const Bits_8) -> Count { return 3; }
+  static constexpr auto max_length(const Bits_16) -> Count { return 5; }
+  static constexpr auto max_length(const Bits_32) -> Count { return 10; }
+  static constexpr auto max_length(const Bits_64) -> Count { return 20; }
+  static constexpr auto max_length(const Signed_8) -> Count { return 1; }
+  static constexpr auto max_length(const Signed_16) -> Count { return 6; }
+  static constexpr auto max_length(const Signed_32) -> Count { return 11; }
+  static constexpr auto max_length(const Signed_64) -> Count { return 20; }
+  static constexpr auto max_length(const Real_32) -> Count {
+    return max_real_length;
+  }
+  static constexpr auto max_length(const Real_64) -> Count {
+    return max_real_length;
+  }
+  static constexpr auto max_length(const View::Bytes raw) -> Count {
+    return raw.get_size();
+  }
+
+  // Writes the same text as operator<< straight into `out`, which must have
+  // room for max_length of the value. Returns the byte after the text.
+  static auto write_unchecked(Bits_8* out, const Bool flag) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Bits_8 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Bits_16 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Bits_32 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Bits_64 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Signed_8 character)
+      -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Signed_16 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Signed_32 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Signed_64 value) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Real_32 real) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const Real_64 real) -> Bits_8*;
+  static auto write_unchecked(Bits_8* out, const View::Bytes raw) -> Bits_8*;
+
   Access::Bytes data;
+  Sink* sink = nullptr;
   Count ptr_location = 0;
   Bool valid_state = true;
 };
 
+template <NullTerminated::CString pattern, typename... argument_types>
+auto Textual::format(const argument_types&... arguments) -> Textual& {
+  using Pattern = FormatPattern<pattern>;
+  static_assert(
+      Pattern::shape.valid,
+      "Format patterns need `{{` and `}}` for literal braces.");
+  static_assert(
+      Pattern::shape.placeholder_count == sizeof...(argument_types),
+      "Format patterns need exactly one argument per `{}`.");
+
+  if (!valid_state) {
+    return *this;
+  }
+
+  Count segment = 0;
+  const Count estimate =
+      Pattern::shape.text_size + (max_length(arguments) + ... + 0);
+  if (!Writer::reserve(data, sink, ptr_location + estimate)) [[unlikely]] {
+    *this << Pattern::get_segment(0);
+    ((*this << arguments << Pattern::get_segment(++segment)), ...);
+    return *this;
+  }
+
+  Bits_8* out = write_unchecked(
+      data.get_data() + ptr_location, Pattern::get_segment(0));
+  ((out = write_unchecked(out, arguments),
+    out = write_unchecked(out, Pattern::get_segment(++segment))),
+   ...);
+  ptr_location = out - data.get_data();
+  return *this;
+}
+
 }  // namespace Perimortem::Core::Writer
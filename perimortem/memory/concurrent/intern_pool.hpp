@@ -0,0 +1,196 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/thread/spin_lock.hpp"
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/data.hpp"
+#include "perimortem/core/hash.hpp"
+#include "perimortem/core/math.hpp"
+
+#include "perimortem/memory/allocator/arena.hpp"
+#include "perimortem/memory/dynamic/intern_pool.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+
+namespace Perimortem::Memory::Concurrent {
+
+// Thread safe version of `Dynamic::InternPool` for parallel front ends.
+//
+// Strings are sharded like `Concurrent::Map`, with each shard owning its map
+// and the arena its strings are copied into. Interning a string that already
+// exists only takes a shared lock on one shard.
+//
+// Ids still have to be dense across every shard, so they come from a single
+// atomic counter and the id to string table is split into chunks that double
+// in size and never move. Looking up the string of a symbol doesn't lock
+// anything since the slot was written before the symbol was handed out.
+//
+// Every shard's arena starts with a page, so there are fewer shards by default
+// than `Concurrent::Map`. Like the map, shards check out memory from the
+// Bibliotheca of whichever thread grows them. `ensure_capacity` covers the
+// tables but string bytes past each shard's first arena page are still taken
+// from the interning thread, so only intern from threads that outlive the pool.
+template <
+    Dynamic::MapVectorization vector_mode = Dynamic::MapVectorization::Scalar,
+    Count shard_count = 16>
+class InternPool {
+  static_assert(
+      shard_count > 1 && (shard_count & (shard_count - 1)) == 0,
+      "Concurrent::InternPool shard count must be a power of 2.");
+
+ public:
+  InternPool() = default;
+  InternPool(const InternPool&) = delete;
+  InternPool(InternPool&&) = delete;
+
+  ~InternPool() {
+    for (Count i = 0; i < chunk_count; i++) {
+      if (chunks[i]) {
+        Core::Bibliotheca::remit(Core::Data::cast<Bits_8>(chunks[i]));
+      }
+    }
+  }
+
+  // Reserve room for `items` strings, both in the shard tables and the id
+  // table.
+  auto ensure_capacity(Count items) -> void {
+    // Leave some slack since shards won't fill exactly evenly.
+    const Count per_shard = items / shard_count;
+    const Count reserve = per_shard + per_shard / 4 + 16;
+    for (Count i = 0; i < shard_count; i++) {
+      shards[i].lock.lock();
+      shards[i].ids.ensure_capacity(reserve);
+      shards[i].lock.unlock();
+    }
+
+    for (Count chunk = 0; items && chunk <= chunk_of(Bits_32(items - 1));
+         chunk++) {
+      get_slot(Bits_32(chunk_start(chunk)));
+    }
+  }
+
+  // Get the symbol for a string, adding it if it's new.
+  auto intern(Core::View::Bytes text) -> Dynamic::Symbol {
+    auto& shard = get_shard(text);
+    shard.lock.lock_shared();
+    const auto found = shard.ids.find(text);
+    const auto existing =
+        found ? Dynamic::Symbol(found->value) : Dynamic::Symbol();
+    shard.lock.unlock_shared();
+
+    if (existing.is_valid()) {
+      return existing;
+    }
+
+    // Another thread may have added it between the locks.
+    shard.lock.lock();
+    const auto entry = shard.ids.find(text);
+    if (entry) {
+      const auto id = entry->value;
+      shard.lock.unlock();
+      return Dynamic::Symbol(id);
+    }
+
+    Bits_8* copy = shard.arena.allocate(text.get_size());
+    Core::Data::copy(copy, text.get_data(), text.get_size());
+    const auto stored = Core::View::Bytes(copy, text.get_size());
+
+    const auto id = __atomic_fetch_add(&next_id, 1, __ATOMIC_RELAXED);
+    get_slot(id) = stored;
+    shard.ids.insert(stored, id);
+    shard.lock.unlock();
+
+    return Dynamic::Symbol(id);
+  }
+
+  // Get the symbol for a string without adding it, invalid if it's missing.
+  auto find(Core::View::Bytes text) const -> Dynamic::Symbol {
+    const auto& shard = get_shard(text);
+    shard.lock.lock_shared();
+    const auto entry = shard.ids.find(text);
+    const auto symbol =
+        entry ? Dynamic::Symbol(entry->value) : Dynamic::Symbol();
+    shard.lock.unlock_shared();
+
+    return symbol;
+  }
+
+  // The string of a symbol from this pool.
+  auto get_view(Dynamic::Symbol symbol) const -> Core::View::Bytes {
+    const auto id = symbol.get_id();
+    const Count chunk = chunk_of(id);
+    const auto views = __atomic_load_n(&chunks[chunk], __ATOMIC_ACQUIRE);
+    return views[id - chunk_start(chunk)];
+  }
+
+  // Number of symbols handed out so far.
+  auto get_size() const -> Count {
+    return __atomic_load_n(&next_id, __ATOMIC_RELAXED);
+  }
+
+  static constexpr auto get_shard_count() -> Count { return shard_count; }
+
+ private:
+  struct alignas(64) Shard {
+    Core::Thread::SharedSpinLock lock;
+    Dynamic::Map<Core::View::Bytes, Bits_32, vector_mode> ids;
+    Allocator::Arena arena;
+  };
+
+  // Chunk `i` holds `first_chunk_size << i` slots, so 23 chunks cover every
+  // 32 bit id.
+  static constexpr Count first_chunk_size = 1024;
+  static constexpr Count chunk_count = 23;
+
+  // `Math::log2` returns the bit width so drop one for the shift.
+  static constexpr Count shard_bits = Core::Math::log2(shard_count) - 1;
+
+  static constexpr auto chunk_of(Bits_32 id) -> Count {
+    return Core::Math::log2(id / first_chunk_size + 1) - 1;
+  }
+
+  static constexpr auto chunk_start(Count chunk) -> Count {
+    return ((Count(1) << chunk) - 1) * first_chunk_size;
+  }
+
+  // Called with the id's shard locked, but chunks are shared between shards
+  // so whoever allocates a chunk first wins and the others give theirs back.
+  auto get_slot(Bits_32 id) -> Core::View::Bytes& {
+    const Count chunk = chunk_of(id);
+    auto views = __atomic_load_n(&chunks[chunk], __ATOMIC_ACQUIRE);
+    if (!views) {
+      const Count slots = first_chunk_size << chunk;
+      auto alloc =
+          Core::Bibliotheca::check_out(slots * sizeof(Core::View::Bytes));
+      auto fresh = Core::Data::cast<Core::View::Bytes>(alloc.ptr);
+
+      Core::View::Bytes* expected = nullptr;
+      if (__atomic_compare_exchange_n(
+              &chunks[chunk], &expected, fresh, false, __ATOMIC_ACQ_REL,
+              __ATOMIC_ACQUIRE)) {
+        views = fresh;
+      } else {
+        Core::Bibliotheca::remit(alloc.ptr);
+        views = expected;
+      }
+    }
+
+    return views[id - chunk_start(chunk)];
+  }
+
+  constexpr auto get_shard(Core::View::Bytes text) const -> const Shard& {
+    return shards[Core::Hash(text).get_value() >> (64 - shard_bits)];
+  }
+
+  constexpr auto get_shard(Core::View::Bytes text) -> Shard& {
+    return shards[Core::Hash(text).get_value() >> (64 - shard_bits)];
+  }
+
+  Shard shards[shard_count];
+  Core::View::Bytes* chunks[chunk_count] = {};
+  Bits_32 next_id = 0;
+};
+
+}  // namespace Perimortem::Memory::Concurrent
@@ -0,0 +1,169 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/thread/spin_lock.hpp"
+#include "perimortem/core/hash.hpp"
+#include "perimortem/core/math.hpp"
+
+#include "perimortem/memory/dynamic/map.hpp"
+
+namespace Perimortem::Memory::Concurrent {
+
+// Thread safe map made of independently locked `Dynamic::Map` shards.
+//
+// The shard is picked from the top bits of the key's hash while the shard's
+// table uses the bottom bits, so keys spread evenly over both. Every shard
+// sits on its own cache line with its lock so threads working on different
+// shards never touch the same line.
+//
+// Each shard is guarded by a shared spin lock. Readers of a shard don't
+// exclude each other, but every shared acquire and release is an atomic add on
+// the shard's lock word, so readers hitting the same shard still contend on
+// that cache line, and they spin while a writer holds the shard. Spreading
+// reads over many shards is what lets read mostly tables (symbols, open
+// documents) scale. Writes lock one shard exclusively.
+//
+// Since references can't outlive the lock, lookups copy values out or run a
+// callback while the shard is locked.
+//
+// Shards check out memory from the Bibliotheca of whichever thread grows them
+// and Bibliotheca memory is released when that thread exits. Either reserve
+// the expected size with `ensure_capacity` from a long lived thread or only
+// insert from threads that outlive the map.
+template <
+    typename key_type,
+    typename value_type,
+    Dynamic::MapVectorization vector_mode = Dynamic::MapVectorization::Scalar,
+    Count shard_count = 64>
+class Map {
+  static_assert(
+      shard_count > 1 && (shard_count & (shard_count - 1)) == 0,
+      "Concurrent::Map shard count must be a power of 2.");
+
+ public:
+  using Table = Dynamic::Map<key_type, value_type, vector_mode>;
+
+  Map() = default;
+  Map(const Map&) = delete;
+  Map(Map&&) = delete;
+
+  // Reserve room for `items` keys spread across the shards.
+  auto ensure_capacity(Count items) -> void {
+    // Leave some slack since shards won't fill exactly evenly.
+    const Count per_shard = items / shard_count;
+    const Count reserve = per_shard + per_shard / 4 + 16;
+    for (Count i = 0; i < shard_count; i++) {
+      shards[i].lock.lock();
+      shards[i].table.ensure_capacity(reserve);
+      shards[i].lock.unlock();
+    }
+  }
+
+  auto insert(const key_type& key, const value_type& value) -> void {
+    auto& shard = get_shard(key);
+    shard.lock.lock();
+    shard.table.insert(key, value);
+    shard.lock.unlock();
+  }
+
+  auto erase(const key_type& key) -> Bool {
+    auto& shard = get_shard(key);
+    shard.lock.lock();
+    const auto erased = shard.table.erase(key);
+    shard.lock.unlock();
+
+    return erased;
+  }
+
+  // Runs `func` on the value for a key while holding the shard exclusively,
+  // default constructing the value if the key is missing.
+  template <typename func_type>
+  auto update(const key_type& key, func_type&& func) -> void {
+    auto& shard = get_shard(key);
+    shard.lock.lock();
+    func(shard.table.at(key));
+    shard.lock.unlock();
+  }
+
+  auto contains(const key_type& key) const -> Bool {
+    const auto& shard = get_shard(key);
+    shard.lock.lock_shared();
+    const auto found = shard.table.contains(key);
+    shard.lock.unlock_shared();
+
+    return found;
+  }
+
+  auto find_or_default(const key_type& key, const value_type& value) const
+      -> value_type {
+    const auto& shard = get_shard(key);
+    shard.lock.lock_shared();
+    value_type result = shard.table.find_or_default(key, value);
+    shard.lock.unlock_shared();
+
+    return result;
+  }
+
+  // Runs `func` on the value for a key while holding a shared lock, returning
+  // if the key was found.
+  template <typename func_type>
+  auto visit(const key_type& key, func_type&& func) const -> Bool {
+    const auto& shard = get_shard(key);
+    shard.lock.lock_shared();
+    const auto entry = shard.table.find(key);
+    if (entry) {
+      func(static_cast<const value_type&>(entry->value));
+    }
+    shard.lock.unlock_shared();
+
+    return entry != nullptr;
+  }
+
+  // Total number of entries. Shards are counted one at a time so the result
+  // is only exact if no other thread is writing.
+  auto get_size() const -> Count {
+    Count size = 0;
+    for (Count i = 0; i < shard_count; i++) {
+      shards[i].lock.lock_shared();
+      size += shards[i].table.get_size();
+      shards[i].lock.unlock_shared();
+    }
+
+    return size;
+  }
+
+  auto reset() -> void {
+    for (Count i = 0; i < shard_count; i++) {
+      shards[i].lock.lock();
+      shards[i].table.reset();
+      shards[i].lock.unlock();
+    }
+  }
+
+  static constexpr auto get_shard_count() -> Count { return shard_count; }
+
+ private:
+  struct alignas(64) Shard {
+    Core::Thread::SharedSpinLock lock;
+    Table table;
+  };
+
+  // `Math::log2` returns the bit width so drop one for the shift.
+  static constexpr Count shard_bits = Core::Math::log2(shard_count) - 1;
+
+  constexpr auto get_shard(const key_type& key) const -> const Shard& {
+    Core::Hash h(key);
+    return shards[h.get_value() >> (64 - shard_bits)];
+  }
+
+  constexpr auto get_shard(const key_type& key) -> Shard& {
+    Core::Hash h(key);
+    return shards[h.get_value() >> (64 - shard_bits)];
+  }
+
+  Shard shards[shard_count];
+};
+
+}  // namespace Perimortem::Memory::Concurrent
@@ -11,46 +11,22 @@ using namespace Perimortem::Memory;
 
 Dynamic::Bytes::Bytes() {}
 Dynamic::Bytes::Bytes(Count reserved_capacity) {
-  auto alloc = Bibliotheca::check_out(reserved_capacity);
-  source_block = alloc.ptr;
-  capacity = alloc.capacity;
+  ensure_capacity(reserved_capacity);
 }
 
-Dynamic::Bytes::Bytes(const Core::View::Bytes view) : size(view.get_size()) {
-  if (view.get_size() == 0) {
-    capacity = 0;
-    source_block = nullptr;
-    return;
-  }
-
-  auto alloc = Bibliotheca::check_out(view.get_size());
-  source_block = alloc.ptr;
-  capacity = alloc.capacity;
-  memcpy(source_block, view.get_data(), view.get_size());
+Dynamic::Bytes::Bytes(const Core::View::Bytes view) {
+  concat(view);
 }
 
 Dynamic::Bytes::Bytes(const Bytes& rhs) {
-  capacity = rhs.capacity;
-  size = rhs.size;
-  if (rhs.size == 0) {
-    return;
-  }
-
   // Bytes don't require any special handling so just memcpy.
-  auto alloc = Bibliotheca::check_out(rhs.size);
-  source_block = alloc.ptr;
-  capacity = alloc.capacity;
-  memcpy(source_block, rhs.source_block, size);
+  concat(rhs.get_view());
 }
 
 Dynamic::Bytes::Bytes(Bytes&& rhs) {
-  size = rhs.size;
-  capacity = rhs.capacity;
-  source_block = rhs.source_block;
-
-  rhs.source_block = nullptr;
-  rhs.size = 0;
-  rhs.capacity = 0;
+  // Both storage types are plain bytes so take the donor's as is.
+  memcpy(&heap, &rhs.heap, sizeof(HeapStorage));
+  rhs.local.tag = inline_flag;
 }
 
 auto Dynamic::Bytes::operator=(Core::View::Bytes view) -> Bytes& {
@@ -64,49 +40,60 @@ auto Dynamic::Bytes::operator=(const Bytes& rhs) -> Bytes& {
 }
 
 auto Dynamic::Bytes::operator=(Bytes&& rhs) -> Bytes& {
-  size = rhs.size;
-  capacity = rhs.capacity;
-
-  rhs.size = 0;
-  rhs.capacity = 0;
+  if (this == &rhs) {
+    return *this;
+  }
 
-  // Swap source blocks and since move isn't "destructive" we can rely on the
-  // destructor form the donor bytes.
-  Data::swap(source_block, rhs.source_block);
+  release();
+  memcpy(&heap, &rhs.heap, sizeof(HeapStorage));
+  rhs.local.tag = inline_flag;
 
   return *this;
 }
 
 Dynamic::Bytes::~Bytes() {
-  reset();
+  release();
 }
 
 auto Dynamic::Bytes::append(Bits_8 b) -> void {
+  const Count size = get_size();
   ensure_capacity(size + 1);
-  source_block[size++] = b;
+  get_data()[size] = b;
+  set_size(size + 1);
 }
 
 auto Dynamic::Bytes::concat(Core::View::Bytes view) -> void {
+  const Count size = get_size();
   ensure_capacity(size + view.get_size());
 
-  Data::copy(source_block + size, view.get_data(), view.get_size());
-  size += view.get_size();
+  Data::copy(get_data() + size, view.get_data(), view.get_size());
+  set_size(size + view.get_size());
 }
 
 auto Dynamic::Bytes::proxy(Core::View::Bytes view) -> void {
+  // A view of our own bytes could be released by the resize, but it always
+  // fits so just slide it to the front.
+  Bits_8* data = get_data();
+  if (view.get_data() >= data && view.get_data() < data + get_capacity()) {
+    memmove(data, view.get_data(), view.get_size());
+    set_size(view.get_size());
+    return;
+  }
+
   forgetful_resize(view.get_size());
 
-  Data::copy(source_block, view.get_data(), view.get_size());
+  Data::copy(get_data(), view.get_data(), view.get_size());
 }
 
 auto Dynamic::Bytes::set(Bits_8 target) -> void {
-  Data::set(source_block, target, get_size());
+  Data::set(get_data(), target, get_size());
 }
 
 auto Dynamic::Bytes::convert(Bits_8 source, Bits_8 target) -> void {
-  for (int i = 0; i < size; i++) {
-    if (source_block[i] == source) {
-      source_block[i] = target;
+  Bits_8* data = get_data();
+  for (Count i = 0; i < get_size(); i++) {
+    if (data[i] == source) {
+      data[i] = target;
     }
   }
 }
@@ -117,72 +104,79 @@ auto Dynamic::Bytes::slice(Count start, Count size) const -> Core::View::Bytes {
   }
 
   return Core::View::Bytes(
-      source_block + start, Math::min(size, get_size() - start));
+      get_data() + start, Math::min(size, get_size() - start));
 }
 
 auto Dynamic::Bytes::resize(Count new_size) -> void {
   ensure_capacity(new_size);
-  size = new_size;
+  set_size(new_size);
 }
 
 auto Dynamic::Bytes::forgetful_resize(Count required_size) -> void {
-  // Always set the size.
-  size = required_size;
+  // Anything that fits inline goes back into the object.
+  if (required_size <= inline_capacity) {
+    release();
+    set_size(required_size);
+    return;
+  }
 
   // Get the capacity bounds and check if we need a realloc.
   // If the block fits in the current Bibliotheca archive then reuse it.
   // If the block size requires at least one step up or step down then request a
   // new block.
-  if (required_size <= capacity && required_size > (capacity >> 1)) {
+  if (!is_inline() && required_size <= heap.capacity &&
+      required_size > (heap.capacity >> 1)) {
+    heap.size = required_size;
     return;
   }
 
-  if (source_block) {
-    Core::Bibliotheca::remit(source_block);
-  }
+  release();
 
   auto alloc = Bibliotheca::check_out(required_size);
-  source_block = alloc.ptr;
-  capacity = alloc.capacity;
+  heap = {alloc.ptr, required_size, alloc.capacity};
 }
 
 auto Dynamic::Bytes::shrink(Count bytes_to_remove) -> void {
+  const Count size = get_size();
   if (bytes_to_remove > size) {
     clear();
     return;
   }
 
-  size -= bytes_to_remove;
-  memmove(source_block, source_block + bytes_to_remove, size);
+  memmove(get_data(), get_data() + bytes_to_remove, size - bytes_to_remove);
+  set_size(size - bytes_to_remove);
 }
 
 auto Dynamic::Bytes::operator[](Count index) const -> Bits_8 {
-  if (index > size) {
+  if (index > get_size()) {
     return 0;
   }
 
-  return source_block[index];
+  return get_data()[index];
 }
 
 auto Dynamic::Bytes::at(Count index) const -> Bits_8 {
-  if (index > size) {
+  if (index > get_size()) {
     return 0;
   }
 
-  return source_block[index];
+  return get_data()[index];
 }
 
 auto Dynamic::Bytes::clear() -> void {
-  size = 0;
+  set_size(0);
 }
 
 auto Dynamic::Bytes::reset() -> void {
-  size = 0;
+  release();
+}
 
-  // In the event the data was moved.
-  if (source_block) {
-    Bibliotheca::remit(source_block);
+auto Dynamic::Bytes::release() -> void {
+  if (!is_inline()) {
+    Bibliotheca::remit(heap.block);
   }
+
+  local.tag = inline_flag;
 }
 
 auto Dynamic::Bytes::ensure_capacity(Count required_size) -> void {
@@ -194,13 +188,12 @@ auto Dynamic::Bytes::ensure_capacity(Count required_size) -> void {
   // Since the current block doesn't fit in the current archive fetch and
   // transfer to a new block.
   auto alloc = Bibliotheca::check_out(required_size);
-
-  if (source_block) {
-    memcpy(alloc.ptr, source_block, size);
-    Bibliotheca::remit(source_block);
+  const Count size = get_size();
+  memcpy(alloc.ptr, get_data(), size);
+  if (!is_inline()) {
+    Bibliotheca::remit(heap.block);
   }
 
   // Update block and get the new capacity.
-  source_block = alloc.ptr;
-  capacity = alloc.capacity;
+  heap = {alloc.ptr, size, alloc.capacity};
 }
@@ -7,11 +7,26 @@
 #include "perimortem/core/access/bytes.hpp"
 #include "perimortem/core/hash.hpp"
 
+namespace Perimortem::Memory::Shared {
+class Bytes;
+}
+
 namespace Perimortem::Memory::Dynamic {
 
 // A vector of dynamically managed bytes with value semantics.
+//
+// Payloads of up to `inline_capacity` bytes are stored inside the object
+// itself so short names and keys never touch the Bibliotheca. Growing past
+// that promotes the bytes to a Bibliotheca block and shrinking back with a
+// `forgetful_resize` or `reset` returns to inline storage.
+//
+// Inline bytes move with the object, so views taken from a short `Bytes` are
+// only good until it's moved. The object never points at itself though, so
+// containers can still relocate it by copying its bytes.
 class Bytes {
  public:
+  static constexpr Count inline_capacity = 23;
+
   Bytes();
   Bytes(Count reserved_capacity);
   Bytes(Core::View::Bytes view);
@@ -63,29 +78,73 @@ class Bytes {
   auto convert(Bits_8 source, Bits_8 target) -> void;
   auto slice(Count start, Count size) const -> Core::View::Bytes;
 
-  constexpr auto get_size() const -> Count { return size; }
-  constexpr auto get_capacity() const -> Count { return capacity; }
+  constexpr auto get_size() const -> Count {
+    return is_inline() ? Count(local.tag & ~inline_flag) : heap.size;
+  }
+  constexpr auto get_capacity() const -> Count {
+    return is_inline() ? inline_capacity : heap.capacity;
+  }
   constexpr auto get_view() const -> const Core::View::Bytes {
-    return Core::View::Bytes(source_block, size);
+    return Core::View::Bytes(get_data(), get_size());
   }
   constexpr auto get_access() -> Core::Access::Bytes {
-    return Core::Access::Bytes(source_block, size);
+    return Core::Access::Bytes(get_data(), get_size());
   }
 
+  // If the bytes are currently stored in the object rather than a block.
+  constexpr auto is_inline() const -> Bool { return local.tag & inline_flag; }
+
   constexpr auto hash() const -> Bits_64 {
     return Core::Hash(get_view()).get_value();
   }
 
-  auto is_empty() { return size == 0; }
+  auto is_empty() { return get_size() == 0; }
 
   auto clear() -> void;
   auto reset() -> void;
   auto ensure_capacity(Count required_size) -> void;
 
  private:
-  Bits_8* source_block = nullptr;
-  Count size = 0;
-  Count capacity = 0;
+  // Shared bytes adopt the block directly instead of copying.
+  friend class Shared::Bytes;
+
+  // The tag shares its byte with the top of the heap capacity, which is always
+  // 0 since no block gets anywhere near 2^56 bytes. Inline storage sets the
+  // top bit and keeps its size in the rest.
+  static constexpr Bits_8 inline_flag = 0x80;
+
+  struct HeapStorage {
+    Bits_8* block;
+    Count size;
+    Count capacity;
+  };
+
+  struct InlineStorage {
+    Bits_8 data[inline_capacity];
+    Bits_8 tag;
+  };
+
+  constexpr auto get_data() const -> Bits_8* {
+    return is_inline() ? const_cast<Bits_8*>(local.data) : heap.block;
+  }
+
+  constexpr auto set_size(Count new_size) -> void {
+    if (is_inline()) {
+      local.tag = inline_flag | Bits_8(new_size);
+    } else {
+      heap.size = new_size;
+    }
+  }
+
+  // Drops the block if there is one and goes back to empty inline storage.
+  auto release() -> void;
+
+  union {
+    HeapStorage heap;
+    InlineStorage local = {.data = {}, .tag = inline_flag};
+  };
 };
 
+static_assert(sizeof(Bytes) == 24);
+
 }  // namespace Perimortem::Memory::Dynamic
@@ -0,0 +1,35 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/math.hpp"
+#include "perimortem/core/writer/sink.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+
+namespace Perimortem::Memory::Dynamic {
+
+// Lets a writer grow a Dynamic::Bytes as it goes rather than sizing the
+// output ahead of time. Writing starts at the front of the bytes.
+//
+// The bytes are grown geometrically and handed over at full capacity, so
+// they're usually larger than what was written. Resize them to the writer's
+// get_location() once done.
+class BytesSink : public Core::Writer::Sink {
+ public:
+  static constexpr Count growth_factor = 2;
+
+  BytesSink(Dynamic::Bytes& target) : target(target) {}
+
+  auto grow(Count required) -> Core::Access::Bytes override {
+    target.resize(Core::Math::max(required, target.get_size() * growth_factor));
+    target.resize(target.get_capacity());
+    return target.get_access();
+  }
+
+ private:
+  Dynamic::Bytes& target;
+};
+
+}  // namespace Perimortem::Memory::Dynamic
@@ -0,0 +1,106 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/data.hpp"
+
+#include "perimortem/memory/allocator/arena.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+#include "perimortem/memory/dynamic/vector.hpp"
+
+namespace Perimortem::Memory::Dynamic {
+
+// Dense id of a string in an intern pool. Two symbols from the same pool are
+// equal exactly when their strings are, so comparing them never touches the
+// bytes.
+struct Symbol {
+  static constexpr Bits_32 invalid_id = ~Bits_32(0);
+
+  constexpr Symbol() = default;
+  constexpr explicit Symbol(Bits_32 id) : id(id) {}
+
+  constexpr auto operator==(const Symbol& rhs) const -> Bool {
+    return id == rhs.id;
+  }
+
+  constexpr auto operator!=(const Symbol& rhs) const -> Bool {
+    return id != rhs.id;
+  }
+
+  constexpr auto is_valid() const -> Bool { return id != invalid_id; }
+  constexpr auto get_id() const -> Bits_32 { return id; }
+
+ private:
+  Bits_32 id = invalid_id;
+};
+
+// Maps strings to dense 32 bit symbols and back.
+//
+// Each distinct string is copied once into the pool's arena, so the views
+// handed back stay valid until the pool is reset no matter what happened to
+// the source text. Ids count up from 0 in interning order which makes them
+// usable as indexes into side tables.
+//
+// See `Concurrent::InternPool` for sharing a pool between threads.
+template <MapVectorization vector_mode = MapVectorization::Scalar>
+class InternPool {
+ public:
+  InternPool() = default;
+  InternPool(const InternPool&) = delete;
+  InternPool(InternPool&&) = delete;
+
+  auto ensure_capacity(Count items) -> void {
+    ids.ensure_capacity(items);
+  }
+
+  // Get the symbol for a string, adding it if it's new.
+  auto intern(Core::View::Bytes text) -> Symbol {
+    const auto entry = ids.find(text);
+    if (entry) {
+      return Symbol(entry->value);
+    }
+
+    Bits_8* copy = arena.allocate(text.get_size());
+    Core::Data::copy(copy, text.get_data(), text.get_size());
+
+    const auto stored = Core::View::Bytes(copy, text.get_size());
+    const auto id = Bits_32(views.get_size());
+    views.insert(stored);
+    ids.insert(stored, id);
+
+    return Symbol(id);
+  }
+
+  // Get the symbol for a string without adding it, invalid if it's missing.
+  auto find(Core::View::Bytes text) const -> Symbol {
+    const auto entry = ids.find(text);
+    return entry ? Symbol(entry->value) : Symbol();
+  }
+
+  auto contains(Core::View::Bytes text) const -> Bool {
+    return ids.contains(text);
+  }
+
+  // The string of a symbol from this pool.
+  constexpr auto get_view(Symbol symbol) const -> Core::View::Bytes {
+    return views.at(symbol.get_id());
+  }
+
+  constexpr auto get_size() const -> Count { return views.get_size(); }
+
+  // Forgets every symbol, invalidating all views and ids.
+  auto reset() -> void {
+    ids.reset();
+    views.clear();
+    arena.reset();
+  }
+
+ private:
+  Allocator::Arena arena;
+  Map<Core::View::Bytes, Bits_32, vector_mode> ids;
+  Vector<Core::View::Bytes> views;
+};
+
+}  // namespace Perimortem::Memory::Dynamic
@@ -0,0 +1,117 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/memory/dynamic/line_index.hpp"
+
+#include "perimortem/core/algorithm/unicode.hpp"
+#include "perimortem/core/math.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+// Index of the last entry that is <= value, with the first entry always 0.
+static auto last_at_or_below(View::Vector<Count> entries, Count value)
+    -> Count {
+  Count low = 0;
+  Count high = entries.get_size();
+  while (high - low > 1) {
+    const Count middle = (low + high) / 2;
+    if (entries[middle] <= value) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+Dynamic::LineIndex::LineIndex(View::Bytes text) {
+  reset(text);
+}
+
+auto Dynamic::LineIndex::reset(View::Bytes source) -> void {
+  text = source;
+  line_starts.clear();
+  block_units.clear();
+
+  line_starts.insert(0);
+  Count units = 0;
+  for (Count start = 0; start <= text.get_size(); start += block_size) {
+    block_units.insert(units);
+
+    const auto block = text.slice(start, block_size);
+    units += Algorithm::utf16_length(block);
+    for (Count i = 0; i < block.get_size(); i++) {
+      if (block[i] == '\n') {
+        line_starts.insert(start + i + 1);
+      }
+    }
+  }
+}
+
+auto Dynamic::LineIndex::get_position(Count offset) const -> Position {
+  offset = Math::min(offset, text.get_size());
+
+  const Count line = get_line(offset);
+  return {
+      .line = line,
+      .column = to_utf16(offset) - to_utf16(line_starts.at(line)),
+  };
+}
+
+auto Dynamic::LineIndex::get_offset(Position position) const -> Count {
+  if (position.line >= get_line_count()) {
+    return text.get_size();
+  }
+
+  // Stop before the newline so long columns stay on their line.
+  const Count start = line_starts.at(position.line);
+  const Count end = position.line + 1 < get_line_count()
+                        ? line_starts.at(position.line + 1) - 1
+                        : text.get_size();
+
+  const Count offset = from_utf16(to_utf16(start) + position.column);
+  return Math::min(offset, end);
+}
+
+auto Dynamic::LineIndex::to_utf16(Count offset) const -> Count {
+  offset = Math::min(offset, text.get_size());
+
+  const Count block = offset / block_size;
+  const Count block_start = block * block_size;
+  return block_units.at(block) +
+         Algorithm::utf16_length_scalar(
+             text.slice(block_start, offset - block_start));
+}
+
+auto Dynamic::LineIndex::from_utf16(Count units) const -> Count {
+  const Count block = last_at_or_below(block_units.get_view(), units);
+
+  // The block may start partway into a code point, but continuation bytes
+  // don't add any units so they're skipped over the same way.
+  Count current = block_units.at(block);
+  for (Count i = block * block_size; i < text.get_size(); i++) {
+    const Bits_8 byte = text[i];
+    if ((byte & 0xC0) == 0x80) {
+      continue;
+    }
+
+    const Count width = byte >= 0xF0 ? 2 : 1;
+    if (current + width > units) {
+      return i;
+    }
+
+    current += width;
+  }
+
+  return text.get_size();
+}
+
+auto Dynamic::LineIndex::get_line(Count offset) const -> Count {
+  return last_at_or_below(line_starts.get_view(), offset);
+}
+
+auto Dynamic::LineIndex::get_line_start(Count line) const -> Count {
+  return line < get_line_count() ? line_starts.at(line) : text.get_size();
+}
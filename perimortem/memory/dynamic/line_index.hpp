@@ -0,0 +1,66 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+
+#include "perimortem/memory/dynamic/vector.hpp"
+
+namespace Perimortem::Memory::Dynamic {
+
+// Converts between byte offsets into UTF-8 text and line / UTF-16 column
+// positions, which is what LSP clients send unless they negotiate otherwise.
+//
+// Building the index records where every line starts plus the number of
+// UTF-16 code units before each 64 byte block. A conversion in either
+// direction is a binary search followed by a walk of at most one block, so
+// it's O(log n) no matter how long the lines are.
+//
+// The index only keeps a view of the text, so it has to be rebuilt (or reset)
+// whenever the text changes or moves. Lines end at '\n'; a '\r' before it is
+// treated as part of the line.
+class LineIndex {
+ public:
+  // Columns are counted in UTF-16 code units.
+  struct Position {
+    Count line;
+    Count column;
+  };
+
+  LineIndex() = default;
+  LineIndex(Core::View::Bytes text);
+
+  auto reset(Core::View::Bytes text) -> void;
+
+  // Position of a byte offset, clamped to the end of the text.
+  auto get_position(Count offset) const -> Position;
+  // Byte offset of a position. Columns past the end of a line clamp to the end
+  // of that line and lines past the end clamp to the end of the text.
+  auto get_offset(Position position) const -> Count;
+
+  // UTF-16 code units before a byte offset.
+  auto to_utf16(Count offset) const -> Count;
+  // Byte offset after a number of UTF-16 code units. Landing between the
+  // halves of a surrogate pair gives the start of that code point.
+  auto from_utf16(Count units) const -> Count;
+
+  // Line containing a byte offset, counting from 0.
+  auto get_line(Count offset) const -> Count;
+  auto get_line_start(Count line) const -> Count;
+
+  constexpr auto get_line_count() const -> Count {
+    return line_starts.get_size();
+  }
+  constexpr auto get_text() const -> Core::View::Bytes { return text; }
+
+ private:
+  static constexpr Count block_size = 64;
+
+  Core::View::Bytes text;
+  Vector<Count> line_starts;
+  // Units before the start of each block, where the last block may be empty.
+  Vector<Count> block_units;
+};
+
+}  // namespace Perimortem::Memory::Dynamic
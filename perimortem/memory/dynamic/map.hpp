@@ -5,15 +5,52 @@
 
 #include <x86intrin.h>
 
+#include "perimortem/core/view/vector.hpp"
+#include "perimortem/core/access/vector.hpp"
 #include "perimortem/core/bibliotheca.hpp"
 #include "perimortem/core/data.hpp"
 #include "perimortem/core/hash.hpp"
+#include "perimortem/core/math.hpp"
+
+#include "perimortem/memory/allocator/arena.hpp"
 
 #include "perimortem/utility/pair.hpp"
 
 namespace Perimortem::Memory::Dynamic {
 
-enum class MapVectorization { Full, Partial, Scalar };
+enum class MapVectorization { Wide, Full, Partial, Scalar };
+enum class MapStorage { Bibliotheca, Arena, Inline };
+
+// Table quality report from `Map::get_statistics`.
+//
+// The layout numbers are measured from the table when the report is made. The
+// probe counters are only kept by maps with `instrumented` set and stay 0 for
+// every other map.
+struct MapStatistics {
+  // Number of buckets holding each entry count. Scalar buckets only ever hold
+  // 0 or 1 entries.
+  Count occupancy[65] = {};
+  Count bucket_count = 0;
+  Count entries = 0;
+
+  // Buckets between an entry's home bucket and the bucket it ended up in.
+  Count total_probe_distance = 0;
+  Count max_probe_distance = 0;
+
+  // Slots whose tag matched during a lookup and how many of those held a
+  // different key.
+  Count tag_matches = 0;
+  Count false_positives = 0;
+  Count growth_events = 0;
+
+  constexpr auto average_probe_distance() const -> Real_64 {
+    return entries ? Real_64(total_probe_distance) / Real_64(entries) : 0.0;
+  }
+
+  constexpr auto false_positive_rate() const -> Real_64 {
+    return tag_matches ? Real_64(false_positives) / Real_64(tag_matches) : 0.0;
+  }
+};
 
 // Unordered flat map with a two stage look up to optimize for insert, delete
 // and find operations. Optimized for value types.
@@ -31,8 +68,8 @@ enum class MapVectorization { Full, Partial, Scalar };
 // Since Perimortem uses 32 byte wide AVX2 registers the buckets are filled up
 // linearly both for improved instruction throughput (and very minor branch
 // performance for iteration) and to improve cache performance for small key /
-// value pairs, although any major gains are offset by storing the 8 hash
-// inline.
+// value pairs, although any major gains are offset by storing the 8 byte hash
+// inline (4 bytes for entries of 4 bytes or less).
 //
 // Map types:
 // * Scalar is optimized for speed and size and should be used for any table
@@ -43,20 +80,77 @@ enum class MapVectorization { Full, Partial, Scalar };
 //
 // * Full should only be used on tables with 1000+ integer keys.
 //
+// * Wide uses 64 byte AVX-512 buckets so a bucket's tags fill exactly one cache
+//   line and matches come straight out of a mask register. Zen4 double pumps
+//   512 bit ops through its 256 bit units so a probe is slightly slower than
+//   Full, but each bucket covers twice the slots which keeps overflow chains
+//   short on large tables near their load limit.
+//
 // Full and Partial typically outperform Scalar when your lookup hit rate ~<25%.
+//
+// `find`, `contains`, `at` and `erase` accept any type that hashes the same as
+// the key through `Core::Hash` and compares equal to it, so a map keyed on
+// `Dynamic::Bytes` can be probed with a `View::Bytes` straight out of a token
+// without building a key first.
+//
+// Growing normally rehashes the whole table in one go which is the fastest
+// way to grow but stalls for milliseconds on tables with millions of entries.
+// Setting `migration_limit` switches to incremental growth where the old table
+// is kept alive and at most `migration_limit` of its buckets are moved into the
+// new table per insert or erase, with lookups checking both tables until the
+// move is done. The default of 0 keeps the single rehash.
+//
+// Storage types:
+// * Bibliotheca checks tables out of the thread's Bibliotheca and remits them
+//   when the map is destroyed.
+//
+// * Arena takes its tables from an `Allocator::Arena` passed to the
+//   constructor. Nothing is returned when the map is destroyed or grows, the
+//   tables are freed along with the arena, so it suits short lived tables that
+//   already share a request's lifetime.
+//
+// * Inline keeps a table for `inline_capacity` entries inside the map itself
+//   so small tables never allocate. Growing past it spills over to the
+//   Bibliotheca. The table makes the map object itself larger: with 8 byte
+//   keys and values it adds 640 bytes in Scalar mode, 800 in Partial and
+//   Full and about 1.6KB in Wide, so keep inline maps out of large arrays.
+//
+// `get_statistics` reports the bucket occupancy and probe distances of any
+// map. Setting `instrumented` also counts tag matches, tag false positives
+// and growth events as the map is used, which costs a few increments per
+// probe so it's meant for tuning hashes and benchmarks.
 template <
     typename key_type,
     typename value_type,
-    MapVectorization vector_mode = MapVectorization::Scalar>
+    MapVectorization vector_mode = MapVectorization::Scalar,
+    Count migration_limit = 0,
+    MapStorage storage = MapStorage::Bibliotheca,
+    Bool instrumented = false>
 class Map {
  public:
   using Entry = Utility::Pair<key_type, value_type>;
 
   // Internal configuration of data type
  private:
+  // Entries of 4 bytes or less (a `Set` of 4 byte keys) keep 32 bits of the
+  // hash so their vector slots pack into 8 bytes instead of 16. That leaves 25
+  // bits for the bucket index, past 2^25 buckets the upper buckets only take
+  // overflow from probes.
+  template <bool packed>
+  struct SlotHash {
+    using Type = Bits_64;
+  };
+
+  template <>
+  struct SlotHash<true> {
+    using Type = Bits_32;
+  };
+
+  using slot_hash_type = SlotHash<sizeof(Entry) <= sizeof(Bits_32)>::Type;
+
   struct SlotInlineHash {
     Entry entry;
-    Bits_64 hash;
+    slot_hash_type hash;
   };
 
   struct SlotEntryOnly {
@@ -68,7 +162,16 @@ class Map {
     using Type = __m256i;
     using MaskType = Bits_32;
     using KeyType = Bits_8;
-    using InputHash = Bits_64;
+    using InputHash = slot_hash_type;
+    using SlotType = SlotInlineHash;
+  };
+
+  template <>
+  struct VectorType<MapVectorization::Wide> {
+    using Type = __m512i;
+    using MaskType = Bits_64;
+    using KeyType = Bits_8;
+    using InputHash = slot_hash_type;
     using SlotType = SlotInlineHash;
   };
 
@@ -77,7 +180,7 @@ class Map {
     using Type = __m128i;
     using MaskType = Bits_16;
     using KeyType = Bits_8;
-    using InputHash = Bits_64;
+    using InputHash = slot_hash_type;
     using SlotType = SlotInlineHash;
   };
 
@@ -98,10 +201,38 @@ class Map {
   static constexpr Count bucket_size = sizeof(vectorize_type);
 
   // Number of elements per bucket to hold back.
-  // Holding back 2 elements results in a load factor of 0.9375 for wide
-  // and a load factor of 0.875 for narrow.
+  // Holding back 2 elements results in a load factor of 0.96875 for Wide,
+  // 0.9375 for Full and a load factor of 0.875 for Partial.
   static constexpr Count load_factor = bucket_size - 2;
 
+  // Vector maps pack slots from the front of each bucket so the occupancy
+  // mask maps directly to slot offsets. Scalar maps have a slot per bucket.
+  static constexpr Count slots_per_bucket =
+      vector_mode == MapVectorization::Scalar ? 1 : bucket_size;
+
+  // Entries a table with `buckets` buckets takes before it has to grow.
+  static constexpr auto capacity_for(Count buckets) -> Count {
+    if constexpr (vector_mode == MapVectorization::Scalar) {
+      return Count(buckets * 0.9);
+    } else {
+      return load_factor * buckets;
+    }
+  }
+
+  // Smallest table that fits `inline_capacity` entries under the load factor,
+  // which is 32 buckets for Scalar, 2 for Partial and 1 for Full and Wide.
+  static constexpr Count inline_capacity = 16;
+  static constexpr Count inline_bucket_count = [] {
+    Count buckets = 1;
+    while (capacity_for(buckets) < inline_capacity) {
+      buckets *= 2;
+    }
+    return buckets;
+  }();
+  static constexpr Count inline_buffer_size =
+      inline_bucket_count *
+      (bucket_size + sizeof(slot_type) * slots_per_bucket);
+
   struct BufferData {
     vectorize_type* bucket_buffer = nullptr;
     slot_type* slots_buffer = nullptr;
@@ -110,12 +241,84 @@ class Map {
     Count total_byte_capacity = 0;
   };
 
+  // The previous table while an incremental resize is in flight. Buckets
+  // before the cursor have been moved and their slots are stale, but their
+  // tags are left in place so probe chains through them stay intact.
+  template <Count limit>
+  struct MigrationState {
+    BufferData previous;
+    Count cursor = 0;
+  };
+
+  // Maps without incremental growth don't pay for the migration state.
+  template <>
+  struct MigrationState<0> {};
+
+  static constexpr Bool incremental = migration_limit > 0;
+
+  // Only the arena and inline modes need anything beyond the table itself.
+  template <MapStorage>
+  struct StorageState {};
+
+  template <>
+  struct StorageState<MapStorage::Arena> {
+    Allocator::Arena* arena;
+  };
+
+  template <>
+  struct StorageState<MapStorage::Inline> {
+    alignas(64) Bits_8 buffer[inline_buffer_size];
+  };
+
+  // Lookups are const so instrumented maps keep their counters mutable.
+  template <bool>
+  struct ProbeCounters {};
+
+  template <>
+  struct ProbeCounters<true> {
+    mutable Count tag_matches;
+    mutable Count false_positives;
+    Count growth_events;
+  };
+
+  // Small tables have nothing to stall on so there's no reason to support
+  // migrating an inline table, which would also complicate moves.
+  static_assert(
+      !incremental || storage != MapStorage::Inline,
+      "Inline maps don't support incremental growth.");
+
  public:
-  Map() { buffer_data = BufferData(); }
-  Map(Count inital_capacity) { ensure_capacity(inital_capacity); }
+  Map()
+    requires(storage != MapStorage::Arena)
+  {
+    buffer_data = initial_buffer();
+  }
+
+  Map(Count inital_capacity)
+    requires(storage != MapStorage::Arena)
+  {
+    buffer_data = initial_buffer();
+    ensure_capacity(inital_capacity);
+  }
+
+  Map(Allocator::Arena& arena)
+    requires(storage == MapStorage::Arena)
+  {
+    storage_state.arena = &arena;
+  }
+
+  Map(Allocator::Arena& arena, Count inital_capacity)
+    requires(storage == MapStorage::Arena)
+  {
+    storage_state.arena = &arena;
+    ensure_capacity(inital_capacity);
+  }
 
   template <Count aggregate_size>
-  constexpr Map(const Entry (&items)[aggregate_size]) {
+  constexpr Map(const Entry (&items)[aggregate_size])
+    requires(storage != MapStorage::Arena)
+  {
+    buffer_data = initial_buffer();
     ensure_capacity(aggregate_size);
 
     for (Count i = 0; i < aggregate_size; i++) {
@@ -123,64 +326,73 @@ class Map {
     }
   }
 
+  // Arena maps copy into the same arena as the source.
   Map(const Map& rhs) {
-    buffer_data = create_buffer(rhs.buffer_data.bucket_count);
-    buffer_data.size = rhs.buffer_data.size;
-    buffer_data.total_byte_capacity = rhs.buffer_data.total_byte_capacity;
-
-    // As long as the two buckets are trivially copyable we can just copy the
-    // buffers 1 for 1.
-    const auto bytes = buffer_data.total_byte_capacity;
-    memcpy(buffer_data.bucket_buffer, rhs.buffer_data.bucket_buffer, bytes);
+    if constexpr (storage == MapStorage::Arena) {
+      storage_state.arena = rhs.storage_state.arena;
+    }
 
-    // If they aren't triviably copyable then we'll need to propagate a bunch of
-    // copy constructor calls.
-    if (!__is_trivially_copyable(key_type) ||
-        !__is_trivially_copyable(value_type)) {
-      auto bucket_count = buffer_data.bucket_count;
-      auto buckets = buffer_data.bucket_buffer;
-      auto slots = buffer_data.slots_buffer;
-      auto source_slots = rhs.buffer_data.slots_buffer;
-      for (Count bucket_index = 0; bucket_index < bucket_count;
-           bucket_index++) {
-        auto occupancy_bits = occupied_slots(buckets[bucket_index]);
+    buffer_data = copy_buffer(rhs.buffer_data, 0);
 
-        if (!occupancy_bits) {
-          continue;
-        }
-
-        auto occupancy_count = __builtin_popcountg(occupancy_bits);
-        for (Count bit_index = 0; bit_index < occupancy_count; bit_index++) {
-          auto target_slot = slots + (bucket_index * bucket_size) + bit_index;
-          auto source_entry =
-              source_slots + (bucket_index * bucket_size) + bit_index;
-          target_slot->entry.key.key_type(source_slots->key);
-          target_slot->entry.value.value_type(source_slots->value);
-        }
+    if constexpr (incremental) {
+      if (rhs.migration.previous.bucket_buffer) {
+        migration.previous =
+            copy_buffer(rhs.migration.previous, rhs.migration.cursor);
+        migration.cursor = rhs.migration.cursor;
       }
     }
   }
 
   Map(Map&& rhs) {
+    if constexpr (storage == MapStorage::Arena) {
+      storage_state.arena = rhs.storage_state.arena;
+    }
+
     buffer_data = rhs.buffer_data;
+    migration = rhs.migration;
+
+    // An inline table can't be stolen so relocate its entries the same way
+    // growing does.
+    if constexpr (storage == MapStorage::Inline) {
+      if (rhs.is_inline(rhs.buffer_data)) {
+        memcpy(
+            storage_state.buffer,
+            rhs.storage_state.buffer,
+            inline_buffer_size);
+        buffer_data = inline_table();
+        buffer_data.size = rhs.buffer_data.size;
+      }
+    }
 
-    rhs.buffer_data = BufferData();
+    rhs.buffer_data = rhs.initial_buffer();
+    rhs.migration = MigrationState<migration_limit>();
   };
 
   ~Map() {
+    release_previous();
+
     if (buffer_data.bucket_buffer) {
-      destruct();
-      Core::Bibliotheca::remit((Bits_8*)buffer_data.bucket_buffer);
+      // Trivial entries have nothing to destroy and the table is on its way
+      // out so there's no need to walk it, which makes arena maps free to
+      // drop.
+      if constexpr (
+          !__is_trivially_destructible(key_type) ||
+          !__is_trivially_destructible(value_type)) {
+        destruct(buffer_data, 0);
+      }
+      release_buffer(buffer_data);
     }
   }
 
+  // Number of keys resolved together by the batched lookups.
+  static constexpr Count batch_width = 16;
+
   auto ensure_capacity(Count items) -> void {
-    if constexpr (vector_mode == MapVectorization::Scalar) {
-      if (buffer_data.bucket_buffer &&
-          items <= buffer_data.bucket_count * 0.9) {
-        return;
-      }
+    if (has_capacity(items)) {
+      return;
+    }
 
+    if constexpr (vector_mode == MapVectorization::Scalar) {
       auto new_bucket_count =
           buffer_data.bucket_count == 0 ? 2 : buffer_data.bucket_count << 1;
       while (new_bucket_count * 0.9 <= items) {
@@ -189,10 +401,6 @@ class Map {
 
       grow(new_bucket_count);
     } else {
-      const auto load_limit = load_factor * buffer_data.bucket_count;
-      if (items <= load_limit) {
-        return;
-      }
       auto new_bucket_count =
           buffer_data.bucket_count == 0 ? 1 : buffer_data.bucket_count << 1;
       while (load_factor * new_bucket_count <= items) {
@@ -204,7 +412,8 @@ class Map {
   }
 
   auto reset() -> void {
-    destruct();
+    release_previous();
+    destruct(buffer_data, 0);
 
     buffer_data.size = 0;
   }
@@ -215,28 +424,19 @@ class Map {
 
   constexpr auto insert(const key_type& key, const value_type& value)
       -> Entry* {
-    ensure_capacity(buffer_data.size + 1);
+    Bool claimed;
+    auto slot = acquire_slot(key, claimed);
 
     // If the entry already exists than overwrite the value.
-    auto entry = find(key);
-    if (entry) {
-      entry->value = value;
-      return entry;
-    }
-
-    auto hash = get_hash(key);
-    auto empty_slot = get_empty(hash);
-    buffer_data.size += 1;
-
-    // Scalar maps store the full hash in the bucket.
-    if constexpr (vector_mode != MapVectorization::Scalar) {
-      empty_slot->hash = hash;
+    if (!claimed) {
+      slot->entry.value = value;
+      return &slot->entry;
     }
 
     // Construct using the copy constructor.
-    new (&empty_slot->entry) Entry(key, value);
+    new (&slot->entry) Entry(key, value);
 
-    return &empty_slot->entry;
+    return &slot->entry;
   }
 
   constexpr auto emplace(Entry&& item) -> Entry* {
@@ -244,64 +444,49 @@ class Map {
   }
 
   constexpr auto emplace(key_type&& key, value_type&& value) -> Entry* {
-    ensure_capacity(buffer_data.size + 1);
+    Bool claimed;
+    auto slot = acquire_slot(key, claimed);
 
     // If the entry already exists than overwrite the value.
-    auto entry = find(key);
-    if (entry) {
-      entry->value = value;
-      return entry;
-    }
-
-    auto hash = get_hash(key);
-    auto empty_slot = get_empty(hash);
-    buffer_data.size += 1;
-
-    // Scalar maps store the full hash in the bucket.
-    if constexpr (vector_mode != MapVectorization::Scalar) {
-      empty_slot->hash = hash;
+    if (!claimed) {
+      slot->entry.value = value;
+      return &slot->entry;
     }
 
     // Construct using the copy constructor.
-    new (&empty_slot->entry) Entry(key, value);
+    new (&slot->entry) Entry(key, value);
 
-    return &empty_slot->entry;
+    return &slot->entry;
   }
 
-  constexpr auto contains(const key_type& key) const -> Bool {
+  template <typename lookup_type>
+  constexpr auto contains(const lookup_type& key) const -> Bool {
     return find(key) != nullptr;
   }
 
-  constexpr auto at(const key_type& key) -> value_type& {
-    auto entry = find(key);
-    if (!entry) {
-      ensure_capacity(buffer_data.size + 1);
-
-      auto hash = get_hash(key);
-      auto empty_slot = get_empty(hash);
-      buffer_data.size += 1;
-
-      // Scalar maps store the full hash in the bucket.
-      if constexpr (vector_mode != MapVectorization::Scalar) {
-        empty_slot->hash = hash;
-      }
-
-      // Construct using the copy constructor.
-      new (&empty_slot->entry) Entry(key, value_type());
-
-      entry = &empty_slot->entry;
+  // The key is only constructed if it's missing, so looking up a
+  // `Dynamic::Bytes` map with a `View::Bytes` only copies the text once.
+  template <typename lookup_type>
+  constexpr auto at(const lookup_type& key) -> value_type& {
+    Bool claimed;
+    auto slot = acquire_slot(key, claimed);
+    if (claimed) {
+      new (&slot->entry) Entry(key_type(key), value_type());
     }
 
     // Return end block
-    return entry->value;
+    return slot->entry.value;
   }
 
-  constexpr auto operator[](const key_type& key) -> value_type& {
+  template <typename lookup_type>
+  constexpr auto operator[](const lookup_type& key) -> value_type& {
     return at(key);
   }
 
-  constexpr auto find_or_default(const key_type& key, const value_type& value)
-      const -> const value_type& {
+  template <typename lookup_type>
+  constexpr auto find_or_default(
+      const lookup_type& key,
+      const value_type& value) const -> const value_type& {
     auto entry = find(key);
     if (!entry) {
       return value;
@@ -310,6 +495,228 @@ class Map {
     }
   }
 
+  // Batched `find`, writing the entry for each key or nullptr if the key is
+  // missing.
+  //
+  // Each group of keys is hashed and has its buckets prefetched, then has its
+  // tags matched and the candidate slots prefetched before any key is
+  // compared. This overlaps the cache misses of the whole group instead of
+  // paying for them one key at a time, which is where miss heavy lookups like
+  // symbol resolution spend most of their time.
+  auto find_batch(
+      Core::View::Vector<key_type> keys,
+      Core::Access::Vector<Entry*> results) const -> void {
+    const Count count = Core::Math::min(keys.get_size(), results.get_size());
+    for (Count start = 0; start < count; start += batch_width) {
+      const Count group = Core::Math::min(batch_width, count - start);
+      resolve_batch(keys.get_data() + start, results.get_data() + start, group);
+    }
+  }
+
+  // Batched `find` over keys stored somewhere else, like the entries of
+  // another table, so they don't need copying into a contiguous array first.
+  auto find_batch(
+      Core::View::Vector<const key_type*> keys,
+      Core::Access::Vector<Entry*> results) const -> void {
+    const Count count = Core::Math::min(keys.get_size(), results.get_size());
+    for (Count start = 0; start < count; start += batch_width) {
+      const Count group = Core::Math::min(batch_width, count - start);
+      resolve_batch(keys.get_data() + start, results.get_data() + start, group);
+    }
+  }
+
+  // Batched `contains`, writing one result per key.
+  auto contains_batch(
+      Core::View::Vector<key_type> keys,
+      Core::Access::Vector<Bool> results) const -> void {
+    const Count count = Core::Math::min(keys.get_size(), results.get_size());
+    Entry* entries[batch_width];
+    for (Count start = 0; start < count; start += batch_width) {
+      const Count group = Core::Math::min(batch_width, count - start);
+      resolve_batch(keys.get_data() + start, entries, group);
+
+      for (Count i = 0; i < group; i++) {
+        results.get_data()[start + i] = entries[i] != nullptr;
+      }
+    }
+  }
+
+  // Removes a key from the map, returning if the key was present.
+  //
+  // Erasing moves other entries to keep every probe chain intact so any
+  // outstanding entry pointers or iterators are invalidated.
+  template <typename lookup_type>
+  constexpr auto erase(const lookup_type& key) -> Bool {
+    if (buffer_data.size == 0) {
+      return false;
+    }
+
+    const auto hash = get_hash(key);
+    if constexpr (incremental) {
+      migrate_buckets(migration_limit);
+
+      // A key that hasn't moved yet is erased from the previous table in
+      // place so erasing stays within the per operation migration bound.
+      auto pending = find_previous(key, hash);
+      if (pending) {
+        erase_entry(migration.previous, pending, migration.cursor);
+        return true;
+      }
+    }
+
+    auto entry = find_in(buffer_data, key, hash, 0);
+    if (!entry) {
+      return false;
+    }
+
+    erase_entry(buffer_data, entry, 0);
+    return true;
+  }
+
+  // Forward iterator over every entry in the map in bucket order.
+  //
+  // Empty buckets are skipped using the same occupancy masks the probes use.
+  // Scalar maps test 8 buckets at a time using the control bit of each hash.
+  class Iterator {
+   public:
+    constexpr auto operator*() const -> Entry& {
+      return (slots + group + __builtin_ctzg(remaining))->entry;
+    }
+
+    constexpr auto operator->() const -> Entry* { return &operator*(); }
+
+    constexpr auto operator++() -> Iterator& {
+      remaining &= remaining - 1;
+      if (!remaining) {
+        advance(group + group_width);
+      }
+
+      return *this;
+    }
+
+    constexpr auto operator==(const Iterator& rhs) const -> Bool {
+      return group == rhs.group && remaining == rhs.remaining;
+    }
+
+    constexpr auto operator!=(const Iterator& rhs) const -> Bool {
+      return !operator==(rhs);
+    }
+
+   private:
+    friend Map;
+
+    // Scalar maps test a group of buckets at once which maps to a run of
+    // slots.
+    static constexpr Count group_width =
+        vector_mode == MapVectorization::Scalar ? 8 : bucket_size;
+
+    // While migrating, the unmoved part of the previous table is walked once
+    // the current table runs out.
+    constexpr Iterator(
+        const BufferData& data,
+        Count bucket_index,
+        const BufferData* pending = nullptr,
+        Count pending_bucket = 0)
+        : buckets(data.bucket_buffer),
+          slots(data.slots_buffer),
+          bucket_count(data.bucket_count),
+          pending(pending),
+          pending_bucket(pending_bucket) {
+      advance(bucket_index * slots_per_bucket);
+    }
+
+    // Move to the first occupied slot at or after a slot offset.
+    constexpr auto advance(Count offset) -> void {
+      remaining = 0;
+      group = offset;
+
+      while (true) {
+        const Count slot_count = bucket_count * slots_per_bucket;
+        while (group < slot_count) {
+          remaining = group_occupancy();
+          if (remaining) {
+            return;
+          }
+
+          group += group_width;
+        }
+
+        if (!pending) {
+          group = slot_count;
+          return;
+        }
+
+        buckets = pending->bucket_buffer;
+        slots = pending->slots_buffer;
+        bucket_count = pending->bucket_count;
+        group = pending_bucket * slots_per_bucket;
+        pending = nullptr;
+      }
+    }
+
+    constexpr auto group_occupancy() const -> Bits_64 {
+      if constexpr (vector_mode == MapVectorization::Scalar) {
+        // Occupied scalar buckets always have the high bit set so the sign
+        // mask of 8 buckets is the occupancy of the group.
+        if (group + group_width <= bucket_count) {
+          const auto block = _mm256_loadu_si256(
+              Core::Data::cast<const __m256i_u>(buckets + group));
+          return Bits_64(_mm256_movemask_ps(_mm256_castsi256_ps(block)));
+        }
+
+        Bits_64 occupancy = 0;
+        for (Count i = group; i < bucket_count; i++) {
+          occupancy |= Bits_64(buckets[i] != 0) << (i - group);
+        }
+        return occupancy;
+      } else {
+        return Bits_64(occupied_slots(buckets[group / bucket_size]));
+      }
+    }
+
+    const vectorize_type* buckets;
+    slot_type* slots;
+    Count bucket_count;
+    const BufferData* pending;
+    Count pending_bucket;
+    Count group = 0;
+    Bits_64 remaining = 0;
+  };
+
+  constexpr auto begin() const -> Iterator {
+    if constexpr (incremental) {
+      if (migration.previous.bucket_buffer) {
+        return Iterator(
+            buffer_data, 0, &migration.previous, migration.cursor);
+      }
+    }
+
+    return Iterator(buffer_data, 0);
+  }
+
+  constexpr auto end() const -> Iterator {
+    if constexpr (incremental) {
+      if (migration.previous.bucket_buffer) {
+        return Iterator(
+            migration.previous, migration.previous.bucket_count);
+      }
+    }
+
+    return Iterator(buffer_data, buffer_data.bucket_count);
+  }
+
+  // Get an entry if it exists.
+  //
+  // The pointer is only valid until the map is modified.
+  template <typename lookup_type>
+  constexpr auto find(const lookup_type& key) const -> Entry* {
+    if (buffer_data.size == 0) {
+      return nullptr;
+    }
+
+    return find_hashed(key, get_hash(key));
+  }
+
   constexpr auto get_size() const -> Count { return buffer_data.size; }
   constexpr auto get_capacity() const -> Count {
     if constexpr (vector_mode == MapVectorization::Scalar) {
@@ -319,34 +726,138 @@ class Map {
     }
   }
   constexpr auto get_memory_consumption() const -> Count {
-    return buffer_data.total_byte_capacity;
+    if constexpr (incremental) {
+      return buffer_data.total_byte_capacity +
+             migration.previous.total_byte_capacity;
+    } else {
+      return buffer_data.total_byte_capacity;
+    }
+  }
+
+  // Measure the current table, see `MapStatistics`. Every bucket is walked so
+  // this is for tuning rather than hot paths. While migrating only the new
+  // table is measured.
+  auto get_statistics() const -> MapStatistics {
+    MapStatistics stats;
+    stats.bucket_count = buffer_data.bucket_count;
+
+    const Count bucket_mask = buffer_data.bucket_count - 1;
+    for (Count bi = 0; bi < buffer_data.bucket_count; bi++) {
+      const auto bucket = buffer_data.bucket_buffer[bi];
+      const auto occupancy_bits = occupied_slots(bucket);
+      Count occupancy_count = 0;
+      if constexpr (vector_mode == MapVectorization::Scalar) {
+        occupancy_count = occupancy_bits ? 1 : 0;
+      } else {
+        occupancy_count = __builtin_popcountg(occupancy_bits);
+      }
+
+      stats.occupancy[occupancy_count]++;
+      stats.entries += occupancy_count;
+      for (Count i = 0; i < occupancy_count; i++) {
+        // Scalar buckets keep the low hash bits so they double as the home.
+        Count home = 0;
+        if constexpr (vector_mode == MapVectorization::Scalar) {
+          home = extract_vector_index(bucket);
+        } else {
+          home = extract_vector_index(
+              buffer_data.slots_buffer[(bi * bucket_size) + i].hash);
+        }
+
+        const Count distance = (bi - home) & bucket_mask;
+        stats.total_probe_distance += distance;
+        stats.max_probe_distance =
+            Core::Math::max(stats.max_probe_distance, distance);
+      }
+    }
+
+    if constexpr (instrumented) {
+      stats.tag_matches = counters.tag_matches;
+      stats.false_positives = counters.false_positives;
+      stats.growth_events = counters.growth_events;
+    }
+
+    return stats;
+  }
+
+  // If the map is still moving entries out of a previous table.
+  constexpr auto is_migrating() const -> Bool {
+    if constexpr (incremental) {
+      return migration.previous.bucket_buffer != nullptr;
+    } else {
+      return false;
+    }
+  }
+
+  // Buckets of the previous table moved so far, or 0 when not migrating.
+  constexpr auto get_migration_cursor() const -> Count {
+    if constexpr (incremental) {
+      return migration.cursor;
+    } else {
+      return 0;
+    }
   }
 
  private:
-  // Get an entry if it exists.
-  constexpr auto find(const key_type& key) const -> Entry* {
-    if (buffer_data.size == 0) {
-      return nullptr;
+  template <typename lookup_type>
+  constexpr auto find_hashed(
+      const lookup_type& key,
+      const input_hash_type hash) const -> Entry* {
+    auto entry = find_in(buffer_data, key, hash, 0);
+    if constexpr (incremental) {
+      if (!entry) {
+        entry = find_previous(key, hash);
+      }
     }
 
-    auto hash = get_hash(key);
-    auto bi = extract_vector_index(hash);
+    return entry;
+  }
+
+  // Look up a key in the previous table, ignoring buckets that were already
+  // migrated.
+  template <typename lookup_type>
+  constexpr auto find_previous(
+      const lookup_type& key,
+      const input_hash_type hash) const -> Entry* {
+    if constexpr (incremental) {
+      if (migration.previous.bucket_buffer) {
+        return find_in(migration.previous, key, hash, migration.cursor);
+      }
+    }
+
+    return nullptr;
+  }
+
+  // Probe a table for a key, skipping matches in buckets before
+  // `first_bucket`.
+  template <typename lookup_type>
+  constexpr auto find_in(
+      const BufferData& data,
+      const lookup_type& key,
+      const input_hash_type hash,
+      Count first_bucket) const -> Entry* {
+    auto bi = extract_vector_index(hash, data.bucket_count);
     auto vi = extract_vector_key(hash);
-    auto buckets = buffer_data.bucket_buffer;
-    auto slots = buffer_data.slots_buffer;
-    auto bucket_count = buffer_data.bucket_count;
+    auto buckets = data.bucket_buffer;
+    auto slots = data.slots_buffer;
+    auto bucket_count = data.bucket_count;
 
     if constexpr (vector_mode == MapVectorization::Scalar) {
-      auto possible_buckets = get_size();
-      for (Count i = 0; i < possible_buckets; i++) {
+      // The chain is bound by the table rather than the entry count since the
+      // previous table keeps the tags of buckets that were already migrated.
+      for (Count i = 0; i < bucket_count; i++) {
+        if (!occupied_slots(buckets[bi])) {
+          return nullptr;
+        }
+
         auto possible_match = extract_possible_matches(buckets[bi], vi);
-        if (possible_match) {
+        if (possible_match && bi >= first_bucket) {
           auto target_slot = slots + bi;
+          count_tag_match();
           if (target_slot->entry.key == key) {
             return &target_slot->entry;
           }
-        } else if (!occupied_slots(buckets[bi])) {
-          return nullptr;
+          count_false_positive();
         }
 
         // If jthe bucket is full then move to the next bucket.
@@ -357,16 +868,21 @@ class Map {
     } else {
       while (true) {
         auto possible_matches = extract_possible_matches(buckets[bi], vi);
+        if (bi < first_bucket) {
+          possible_matches = 0;
+        }
 
         while (possible_matches) {
           auto index = __builtin_ctzg(possible_matches);
           auto target_slot = slots + (bi * bucket_size) + index;
+          count_tag_match();
           if (target_slot->hash == hash && target_slot->entry.key == key) {
             return &target_slot->entry;
           }
+          count_false_positive();
 
           // Remove the incorrect match.
-          possible_matches ^= 1 << index;
+          possible_matches &= possible_matches - 1;
         }
 
         // If the bucket isn't full then the key isn't contained in the map.
@@ -381,6 +897,167 @@ class Map {
     }
   }
 
+  // Returns the slot holding a key or claims a new slot for it, setting
+  // `claimed` if the caller needs to construct the entry.
+  //
+  // The table only grows once we know the key is missing so overwriting an
+  // existing key never moves entries around.
+  template <typename lookup_type>
+  constexpr auto acquire_slot(const lookup_type& key, Bool& claimed)
+      -> slot_type* {
+    const auto hash = get_hash(key);
+    if constexpr (incremental) {
+      migrate_buckets(migration_limit);
+    }
+
+    if (!has_capacity(buffer_data.size + 1)) {
+      auto entry = buffer_data.size ? find_hashed(key, hash) : nullptr;
+      if (entry) {
+        claimed = false;
+        return slot_of(entry);
+      }
+
+      ensure_capacity(buffer_data.size + 1);
+    } else if (is_migrating()) {
+      // Keys that haven't migrated yet are updated in place.
+      auto entry = find_previous(key, hash);
+      if (entry) {
+        claimed = false;
+        return slot_of(entry);
+      }
+    }
+
+    auto slot = find_or_claim(key, hash, claimed);
+    if (claimed) {
+      buffer_data.size += 1;
+
+      // Scalar maps store the full hash in the bucket.
+      if constexpr (vector_mode != MapVectorization::Scalar) {
+        slot->hash = hash;
+      }
+    }
+
+    return slot;
+  }
+
+  // Single probe version of `find` followed by `get_empty`.
+  //
+  // Probe chains end at the first bucket with space, which is exactly the
+  // bucket `get_empty` would pick for the same hash, so a missing key can claim
+  // its slot where the search stopped instead of walking the chain twice.
+  template <typename lookup_type>
+  constexpr auto find_or_claim(
+      const lookup_type& key,
+      const input_hash_type hash,
+      Bool& claimed) -> slot_type* {
+    auto bi = extract_vector_index(hash);
+    auto vi = extract_vector_key(hash);
+    auto buckets = buffer_data.bucket_buffer;
+    auto slots = buffer_data.slots_buffer;
+    auto bucket_count = buffer_data.bucket_count;
+
+    if constexpr (vector_mode == MapVectorization::Scalar) {
+      while (true) {
+        if (extract_possible_matches(buckets[bi], vi)) {
+          count_tag_match();
+          if (slots[bi].entry.key == key) {
+            claimed = false;
+            return slots + bi;
+          }
+          count_false_positive();
+        } else if (!occupied_slots(buckets[bi])) {
+          buckets[bi] = vi;
+          claimed = true;
+          return slots + bi;
+        }
+
+        bi = (bi + 1) & (bucket_count - 1);
+      }
+    } else {
+      while (true) {
+        auto possible_matches = extract_possible_matches(buckets[bi], vi);
+
+        while (possible_matches) {
+          auto index = __builtin_ctzg(possible_matches);
+          auto target_slot = slots + (bi * bucket_size) + index;
+          count_tag_match();
+          if (target_slot->hash == hash && target_slot->entry.key == key) {
+            claimed = false;
+            return target_slot;
+          }
+          count_false_positive();
+
+          // Remove the incorrect match.
+          possible_matches &= possible_matches - 1;
+        }
+
+        auto occupancy_bits = occupied_slots(buckets[bi]);
+        if (!full_block(occupancy_bits)) {
+          auto occupancy_count = __builtin_popcountg(occupancy_bits);
+          bucket_tags(bi)[occupancy_count] = vi;
+          claimed = true;
+          return slots + (bi * bucket_size) + occupancy_count;
+        }
+
+        bi = (bi + 1) & (bucket_count - 1);
+      }
+    }
+  }
+
+  // Resolve a group of at most `batch_width` keys in three passes so the
+  // memory accesses of every key are in flight before the first comparison.
+  // The group holds either the keys themselves or pointers to them.
+  template <typename key_source>
+  auto resolve_batch(const key_source* keys, Entry** results, Count group) const
+      -> void {
+    if (buffer_data.size == 0) {
+      for (Count i = 0; i < group; i++) {
+        results[i] = nullptr;
+      }
+      return;
+    }
+
+    auto buckets = buffer_data.bucket_buffer;
+    auto slots = buffer_data.slots_buffer;
+
+    // Scalar maps have a slot per bucket so both lines can be requested
+    // straight away.
+    input_hash_type hashes[batch_width];
+    for (Count i = 0; i < group; i++) {
+      hashes[i] = get_hash(batch_key(keys[i]));
+      const auto bi = extract_vector_index(hashes[i]);
+      __builtin_prefetch(buckets + bi);
+      if constexpr (vector_mode == MapVectorization::Scalar) {
+        __builtin_prefetch(slots + bi);
+      }
+    }
+
+    // Vector maps need the tags to know which slot line to request.
+    if constexpr (vector_mode != MapVectorization::Scalar) {
+      for (Count i = 0; i < group; i++) {
+        const auto bi = extract_vector_index(hashes[i]);
+        const auto possible_matches = extract_possible_matches(
+            buckets[bi], extract_vector_key(hashes[i]));
+        if (possible_matches) {
+          __builtin_prefetch(
+              slots + (bi * bucket_size) + __builtin_ctzg(possible_matches));
+        }
+      }
+    }
+
+    for (Count i = 0; i < group; i++) {
+      results[i] = find_hashed(batch_key(keys[i]), hashes[i]);
+    }
+  }
+
+  static constexpr auto batch_key(const key_type& key) -> const key_type& {
+    return key;
+  }
+
+  static constexpr auto batch_key(const key_type* key) -> const key_type& {
+    return *key;
+  }
+
   // Gets an empty bucket for a hash and set it as used.
   constexpr auto get_empty(const input_hash_type hash) -> slot_type* {
     auto bi = extract_vector_index(hash);
@@ -417,13 +1094,159 @@ class Map {
     memcpy(Core::Data::cast<void>(empty_slot), slot, sizeof(slot_type));
   }
 
-  auto destruct() -> void {
+  // Destroys an entry of `data` and closes the gap it leaves.
+  //
+  // Buckets before `first_bucket` only hold stale copies of entries that were
+  // already migrated, so they're never pulled back into the gap where they
+  // would be migrated a second time. Their own probe chains may break but
+  // nothing looks them up in that table anymore.
+  auto erase_entry(BufferData& data, Entry* entry, Count first_bucket)
+      -> void {
+    // The entry is the first member of the slot so the slot offset gives us
+    // back the bucket and position without a second probe.
+    const Count offset = slot_of(entry) - data.slots_buffer;
+    entry->key.~key_type();
+    entry->value.~value_type();
+    buffer_data.size -= 1;
+
+    if constexpr (vector_mode == MapVectorization::Scalar) {
+      close_scalar_gap(data, offset, first_bucket);
+    } else {
+      close_vector_gap(
+          data, offset / bucket_size, offset % bucket_size, first_bucket);
+    }
+  }
+
+  // Linear probing backward shift for scalar maps.
+  //
+  // Walk the probe chain after the removed slot and pull back any entry whose
+  // home bucket is at or before the hole so it stays reachable, then move the
+  // hole to where the entry came from. The chain ends at the first empty
+  // bucket.
+  static auto close_scalar_gap(BufferData& data, Count hole, Count first_bucket)
+      -> void {
+    auto buckets = data.bucket_buffer;
+    auto slots = data.slots_buffer;
+    const Count bucket_mask = data.bucket_count - 1;
+
+    Count bi = (hole + 1) & bucket_mask;
+    while (buckets[bi]) {
+      // Scalar buckets keep the low hash bits so they double as the home.
+      const Count home = extract_vector_index(buckets[bi], data.bucket_count);
+      if (bi >= first_bucket &&
+          ((bi - home) & bucket_mask) >= ((bi - hole) & bucket_mask)) {
+        memcpy(
+            Core::Data::cast<void>(slots + hole), slots + bi,
+            sizeof(slot_type));
+        buckets[hole] = buckets[bi];
+        hole = bi;
+      }
+
+      bi = (bi + 1) & bucket_mask;
+    }
+
+    buckets[hole] = 0;
+  }
+
+  // Removes a slot from a vector bucket while keeping the bucket packed.
+  //
+  // Probes only continue past full buckets, so if the bucket was full before
+  // the removal any entry that overflowed past it has to be pulled back into
+  // the free slot, which in turn frees a slot further down the chain.
+  static auto close_vector_gap(
+      BufferData& data,
+      Count hole,
+      Count index,
+      Count first_bucket) -> void {
+    const Count bucket_mask = data.bucket_count - 1;
+    Bool was_full = remove_packed(data, hole, index);
+
+    Count bi = hole;
+    while (was_full) {
+      bi = (bi + 1) & bucket_mask;
+      const auto occupancy_bits = occupied_slots(data.bucket_buffer[bi]);
+      const Count occupancy_count =
+          bi >= first_bucket ? __builtin_popcountg(occupancy_bits) : 0;
+
+      // Look for an entry whose probe chain passes through the hole.
+      auto candidates = data.slots_buffer + (bi * bucket_size);
+      for (Count i = 0; i < occupancy_count; i++) {
+        const Count home =
+            extract_vector_index(candidates[i].hash, data.bucket_count);
+        if (((bi - home) & bucket_mask) < ((bi - hole) & bucket_mask)) {
+          continue;
+        }
+
+        // The hole has exactly one free slot at the end of the bucket.
+        const Count tail = bucket_size - 1;
+        auto target = data.slots_buffer + (hole * bucket_size) + tail;
+        memcpy(
+            Core::Data::cast<void>(target),
+            candidates + i,
+            sizeof(slot_type));
+        Core::Data::cast<Bits_8>(data.bucket_buffer + hole)[tail] =
+            Core::Data::cast<Bits_8>(data.bucket_buffer + bi)[i];
+
+        was_full = remove_packed(data, bi, i);
+        hole = bi;
+        break;
+      }
+
+      // A bucket that wasn't full ends every probe chain that reaches it.
+      if (!full_block(occupancy_bits)) {
+        return;
+      }
+    }
+  }
+
+  // Fills a removed slot with the last slot of the bucket, returning if the
+  // bucket was full before the removal.
+  static auto remove_packed(BufferData& data, Count bucket_index, Count index)
+      -> Bool {
+    const auto occupancy_bits =
+        occupied_slots(data.bucket_buffer[bucket_index]);
+    const Count last = __builtin_popcountg(occupancy_bits) - 1;
+    auto tags = Core::Data::cast<Bits_8>(data.bucket_buffer + bucket_index);
+    auto bucket_slots = data.slots_buffer + (bucket_index * bucket_size);
+
+    if (index != last) {
+      memcpy(
+          Core::Data::cast<void>(bucket_slots + index), bucket_slots + last,
+          sizeof(slot_type));
+      tags[index] = tags[last];
+    }
+    tags[last] = 0;
+
+    return full_block(occupancy_bits);
+  }
+
+  // Entries are the first member of a slot.
+  static constexpr auto slot_of(Entry* entry) -> slot_type* {
+    return Core::Data::cast<slot_type>(entry);
+  }
+
+  constexpr auto has_capacity(Count items) const -> Bool {
+    if constexpr (vector_mode == MapVectorization::Scalar) {
+      return buffer_data.bucket_buffer &&
+             items <= capacity_for(buffer_data.bucket_count);
+    } else {
+      return items <= capacity_for(buffer_data.bucket_count);
+    }
+  }
+
+  constexpr auto bucket_tags(Count bucket_index) -> Bits_8* {
+    return Core::Data::cast<Bits_8>(buffer_data.bucket_buffer + bucket_index);
+  }
+
+  // Destruct every entry from `first_bucket` onwards and clear the buckets.
+  static auto destruct(BufferData& data, Count first_bucket) -> void {
     // Look over all slots and destruct the keys and values.
-    auto buckets = buffer_data.bucket_buffer;
-    auto slots = buffer_data.slots_buffer;
-    auto bucket_count = buffer_data.bucket_count;
+    auto buckets = data.bucket_buffer;
+    auto slots = data.slots_buffer;
+    auto bucket_count = data.bucket_count;
 
-    for (Count bucket_index = 0; bucket_index < bucket_count; bucket_index++) {
+    for (Count bucket_index = first_bucket; bucket_index < bucket_count;
+         bucket_index++) {
       auto occupancy_bits = occupied_slots(buckets[bucket_index]);
 
       if (!occupancy_bits) {
@@ -448,7 +1271,39 @@ class Map {
     }
   }
 
+  constexpr auto count_tag_match() const -> void {
+    if constexpr (instrumented) {
+      counters.tag_matches++;
+    }
+  }
+
+  constexpr auto count_false_positive() const -> void {
+    if constexpr (instrumented) {
+      counters.false_positives++;
+    }
+  }
+
   auto grow(const Count new_bucket_count) -> void {
+    if constexpr (instrumented) {
+      counters.growth_events++;
+    }
+
+    if constexpr (incremental) {
+      // Growing again before the last migration finished has to finish it
+      // first, otherwise we'd need to track more than two tables.
+      migrate_buckets(migration.previous.bucket_count);
+
+      // Keep the current table around and let the following operations move
+      // it over a few buckets at a time.
+      if (buffer_data.size) {
+        migration.previous = buffer_data;
+        migration.cursor = 0;
+        buffer_data = create_buffer(new_bucket_count);
+        buffer_data.size = migration.previous.size;
+        return;
+      }
+    }
+
     // Store the old values to clone.
     auto current_buffer = buffer_data;
 
@@ -482,25 +1337,95 @@ class Map {
       }
     }
 
-    // Remit the old block.
+    // Release the old block.
     if (current_buffer.bucket_buffer) {
-      Core::Bibliotheca::remit((Bits_8*)current_buffer.bucket_buffer);
+      release_buffer(current_buffer);
     }
     buffer_data.size = current_buffer.size;
   }
 
-  constexpr auto get_hash(const key_type& key) const -> input_hash_type {
-    Core::Hash h(key);
-    return input_hash_type(h.get_value());
+  // Move up to `bucket_limit` buckets from the previous table into the current
+  // one, releasing the previous table once every bucket has moved.
+  //
+  // Entries are relocated with a memcpy like `grow` does and the stale copies
+  // are left behind for the previous table to be remitted with.
+  auto migrate_buckets(Count bucket_limit) -> void {
+    if constexpr (incremental) {
+      auto& previous = migration.previous;
+      if (!previous.bucket_buffer) {
+        return;
+      }
+
+      const Count last = Core::Math::min(
+          migration.cursor + bucket_limit, Count(previous.bucket_count));
+      for (; migration.cursor < last; migration.cursor++) {
+        const Count bucket_index = migration.cursor;
+        auto occupancy_bits =
+            occupied_slots(previous.bucket_buffer[bucket_index]);
+        if (!occupancy_bits) {
+          continue;
+        }
+
+        if constexpr (vector_mode == MapVectorization::Scalar) {
+          auto valid_slot = previous.slots_buffer + bucket_index;
+          emplace_hashed(valid_slot, previous.bucket_buffer[bucket_index]);
+        } else {
+          auto occupancy_count = __builtin_popcountg(occupancy_bits);
+          for (Count entry_index = 0; entry_index < occupancy_count;
+               entry_index++) {
+            auto valid_slot = previous.slots_buffer +
+                              (bucket_index * bucket_size) + entry_index;
+            emplace_hashed(valid_slot, valid_slot->hash);
+          }
+        }
+      }
+
+      if (migration.cursor == previous.bucket_count) {
+        release_buffer(previous);
+        migration = MigrationState<migration_limit>();
+      }
+    }
+  }
+
+  // Destroy the entries that never left the previous table and drop it.
+  auto release_previous() -> void {
+    if constexpr (incremental) {
+      if (migration.previous.bucket_buffer) {
+        destruct(migration.previous, migration.cursor);
+        release_buffer(migration.previous);
+        migration = MigrationState<migration_limit>();
+      }
+    }
+  }
+
+  // Lookups only need to hash the same as the key through `Core::Hash` and
+  // compare equal to it. Arithmetic keys are converted first since a signed
+  // and unsigned integer can compare equal while hashing differently.
+  template <typename lookup_type>
+  constexpr auto get_hash(const lookup_type& key) const -> input_hash_type {
+    if constexpr (__is_arithmetic(key_type)) {
+      const key_type converted = key_type(key);
+      Core::Hash h(converted);
+      return input_hash_type(h.get_value());
+    } else {
+      Core::Hash h(key);
+      return input_hash_type(h.get_value());
+    }
   }
 
-  // Shift out the 7 bits used for the key.
   constexpr auto extract_vector_index(input_hash_type hash_key) const
       -> input_hash_type {
+    return extract_vector_index(hash_key, buffer_data.bucket_count);
+  }
+
+  // Shift out the 7 bits used for the key.
+  static constexpr auto extract_vector_index(
+      input_hash_type hash_key,
+      Count bucket_count) -> input_hash_type {
     if constexpr (vector_mode == MapVectorization::Scalar) {
-      return hash_key & (buffer_data.bucket_count - 1);
+      return hash_key & (bucket_count - 1);
     } else {
-      return (hash_key >> 7) & (buffer_data.bucket_count - 1);
+      return (hash_key >> 7) & (bucket_count - 1);
     }
   }
 
@@ -525,6 +1450,9 @@ class Map {
       const auto test_vector = _mm_set1_epi8(vi);
       const auto mask = _mm_cmpeq_epi8(bucket, test_vector);
       return mask_type(_mm_movemask_epi8(mask));
+    } else if constexpr (vector_mode == MapVectorization::Wide) {
+      const auto test_vector = _mm512_set1_epi8(vi);
+      return mask_type(_mm512_cmpeq_epi8_mask(bucket, test_vector));
     } else {
       const auto test_vector = _mm256_set1_epi8(vi);
       const auto mask = _mm256_cmpeq_epi8(bucket, test_vector);
@@ -538,6 +1466,8 @@ class Map {
       return bucket != 0;
     } else if constexpr (vector_mode == MapVectorization::Partial) {
       return mask_type(_mm_movemask_epi8(bucket));
+    } else if constexpr (vector_mode == MapVectorization::Wide) {
+      return mask_type(_mm512_movepi8_mask(bucket));
     } else {
       return mask_type(_mm256_movemask_epi8(bucket));
     }
@@ -557,6 +1487,8 @@ class Map {
       *bucket = 0;
     } else if constexpr (vector_mode == MapVectorization::Partial) {
       *bucket = _mm_setzero_pd();
+    } else if constexpr (vector_mode == MapVectorization::Wide) {
+      *bucket = _mm512_setzero_si512();
     } else {
       *bucket = _mm256_setzero_pd();
     }
@@ -579,17 +1511,82 @@ class Map {
     return header_size + buffer_size;
   }
 
-  static auto create_buffer(Count buckets) -> BufferData {
+  // Copy a table, constructing entries from `first_bucket` onwards. Slots
+  // before it only hold stale bytes of already migrated entries.
+  auto copy_buffer(const BufferData& source, Count first_bucket)
+      -> BufferData {
+    if (!source.bucket_buffer) {
+      return BufferData();
+    }
+
+    auto copy = create_buffer(source.bucket_count);
+    copy.size = source.size;
+
+    // As long as the two buckets are trivially copyable we can just copy the
+    // buffers 1 for 1.
+    memcpy(
+        copy.bucket_buffer,
+        source.bucket_buffer,
+        required_buffer_size(source.bucket_count));
+
+    // If they aren't triviably copyable then we'll need to propagate a bunch of
+    // copy constructor calls.
+    if (!__is_trivially_copyable(key_type) ||
+        !__is_trivially_copyable(value_type)) {
+      for (Count bucket_index = first_bucket;
+           bucket_index < copy.bucket_count;
+           bucket_index++) {
+        auto occupancy_bits = occupied_slots(copy.bucket_buffer[bucket_index]);
+        Count occupancy_count = 0;
+        if constexpr (vector_mode == MapVectorization::Scalar) {
+          occupancy_count = occupancy_bits ? 1 : 0;
+        } else {
+          occupancy_count = __builtin_popcountg(occupancy_bits);
+        }
+
+        for (Count bit_index = 0; bit_index < occupancy_count; bit_index++) {
+          const Count offset = (bucket_index * slots_per_bucket) + bit_index;
+          new (&copy.slots_buffer[offset].entry)
+              Entry(source.slots_buffer[offset].entry);
+        }
+      }
+    }
+
+    return copy;
+  }
+
+  auto create_buffer(Count buckets) -> BufferData {
+    if constexpr (storage == MapStorage::Inline) {
+      if (buckets == inline_bucket_count) {
+        auto new_buffer = inline_table();
+        for (Count i = 0; i < buckets; i++) {
+          clear_bucket(new_buffer.bucket_buffer + i);
+        }
+
+        return new_buffer;
+      }
+    }
+
     BufferData new_buffer;
     new_buffer.bucket_count = buckets;
     const auto required_size = required_buffer_size(new_buffer.bucket_count);
-    const auto alloc = Core::Bibliotheca::check_out(required_size);
 
-    // Store the total capacity in bytes for buffer copies later.
-    new_buffer.total_byte_capacity = alloc.capacity;
+    if constexpr (storage == MapStorage::Arena) {
+      // Arena allocations are only 8 byte aligned so over allocate enough to
+      // line the buckets up with a cache line.
+      const auto block = storage_state.arena->allocate(required_size + 64);
+      new_buffer.total_byte_capacity = required_size + 64;
+      new_buffer.bucket_buffer = (vectorize_type*)(Core::Data::align<64>(
+          Count(block)));
+    } else {
+      const auto alloc = Core::Bibliotheca::check_out(required_size);
+
+      // Store the total capacity in bytes for buffer copies later.
+      new_buffer.total_byte_capacity = alloc.capacity;
 
-    // Blocks from the Bibliotheca are always 64 byte aligned.
-    new_buffer.bucket_buffer = Core::Data::cast<vectorize_type>(alloc.ptr);
+      // Blocks from the Bibliotheca are always 64 byte aligned.
+      new_buffer.bucket_buffer = Core::Data::cast<vectorize_type>(alloc.ptr);
+    }
     // slot_type data is everything directly after the bucket count.
     // This keeps us 32 byte aligned which should be good for any types.
     new_buffer.slots_buffer =
@@ -602,7 +1599,56 @@ class Map {
     return new_buffer;
   }
 
+  // Layout of the inline table, leaving whatever it holds alone.
+  auto inline_table() -> BufferData {
+    BufferData new_buffer;
+    if constexpr (storage == MapStorage::Inline) {
+      new_buffer.bucket_count = inline_bucket_count;
+      new_buffer.total_byte_capacity = inline_buffer_size;
+      new_buffer.bucket_buffer =
+          Core::Data::cast<vectorize_type>(storage_state.buffer);
+      new_buffer.slots_buffer = Core::Data::cast<slot_type>(
+          new_buffer.bucket_buffer + inline_bucket_count);
+    }
+
+    return new_buffer;
+  }
+
+  // Inline maps start on their inline table while the others wait for the
+  // first insert to allocate.
+  auto initial_buffer() -> BufferData {
+    if constexpr (storage == MapStorage::Inline) {
+      return create_buffer(inline_bucket_count);
+    } else {
+      return BufferData();
+    }
+  }
+
+  constexpr auto is_inline(const BufferData& data) const -> Bool {
+    if constexpr (storage == MapStorage::Inline) {
+      return Core::Data::cast<Bits_8>(data.bucket_buffer) ==
+             storage_state.buffer;
+    } else {
+      return false;
+    }
+  }
+
+  // Hand a table back to wherever it came from. Arena tables are freed along
+  // with the arena and the inline table is part of the map.
+  auto release_buffer(const BufferData& data) -> void {
+    if constexpr (storage == MapStorage::Bibliotheca) {
+      Core::Bibliotheca::remit((Bits_8*)data.bucket_buffer);
+    } else if constexpr (storage == MapStorage::Inline) {
+      if (!is_inline(data)) {
+        Core::Bibliotheca::remit((Bits_8*)data.bucket_buffer);
+      }
+    }
+  }
+
   BufferData buffer_data;
+  [[no_unique_address]] MigrationState<migration_limit> migration;
+  [[no_unique_address]] StorageState<storage> storage_state;
+  [[no_unique_address]] ProbeCounters<bool(instrumented)> counters = {};
 };
 
 }  // namespace Perimortem::Memory::Dynamic
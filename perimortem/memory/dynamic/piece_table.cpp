@@ -0,0 +1,340 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/memory/dynamic/piece_table.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+// Index of the first newline at or after an offset.
+static auto first_newline_from(View::Vector<Count> offsets, Count offset)
+    -> Count {
+  Count low = 0;
+  Count high = offsets.get_size();
+  while (low < high) {
+    const Count middle = (low + high) / 2;
+    if (offsets[middle] < offset) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+Dynamic::PieceTable::PieceTable() {
+  reset(View::Bytes());
+}
+
+Dynamic::PieceTable::PieceTable(View::Bytes original) {
+  reset(original);
+}
+
+auto Dynamic::PieceTable::reset(View::Bytes text) -> void {
+  original.bytes.clear();
+  original.newline_offsets.clear();
+  added.bytes.clear();
+  added.newline_offsets.clear();
+  nodes.clear();
+  free_nodes.clear();
+
+  nodes.insert(Node{});
+  append_text(original, text);
+  root = text.get_size() ? create_node(Source::Original, 0, text.get_size())
+                         : 0;
+}
+
+auto Dynamic::PieceTable::insert(Count offset, View::Bytes text) -> void {
+  if (text.get_size() == 0) {
+    return;
+  }
+
+  offset = Math::min(offset, get_size());
+  const Count start = added.bytes.get_size();
+  append_text(added, text);
+
+  Bits_32 lhs;
+  Bits_32 rhs;
+  split(root, offset, lhs, rhs);
+
+  // Typing tends to insert right after the last insert, which is exactly where
+  // the last added piece ends.
+  const Count newlines = count_newlines(Source::Added, start, text.get_size());
+  if (!try_extend_last(lhs, text.get_size(), newlines)) {
+    lhs = merge(lhs, create_node(Source::Added, start, text.get_size()));
+  }
+
+  root = merge(lhs, rhs);
+}
+
+auto Dynamic::PieceTable::erase(Count offset, Count size) -> void {
+  offset = Math::min(offset, get_size());
+  size = Math::min(size, get_size() - offset);
+  if (size == 0) {
+    return;
+  }
+
+  Bits_32 lhs;
+  Bits_32 middle;
+  Bits_32 rhs;
+  split(root, offset, lhs, rhs);
+  split(rhs, size, middle, rhs);
+  free_tree(middle);
+
+  root = merge(lhs, rhs);
+}
+
+auto Dynamic::PieceTable::replace(Count offset, Count size, View::Bytes text)
+    -> void {
+  erase(offset, size);
+  insert(offset, text);
+}
+
+auto Dynamic::PieceTable::copy(
+    Count offset,
+    Count size,
+    Dynamic::Bytes& output) const -> void {
+  visit(offset, size, [&](View::Bytes chunk) { output.concat(chunk); });
+}
+
+auto Dynamic::PieceTable::get_line_start(Count line) const -> Count {
+  if (line == 0) {
+    return 0;
+  }
+
+  if (line >= get_line_count()) {
+    return get_size();
+  }
+
+  // Find the piece holding the newline that ends the previous line.
+  Count target = line - 1;
+  Count offset = 0;
+  Bits_32 index = root;
+  while (index) {
+    const Node& node = nodes.at(index);
+    const Node& left = nodes.at(node.left);
+    if (target < left.total_newlines) {
+      index = node.left;
+      continue;
+    }
+
+    target -= left.total_newlines;
+    offset += left.total_size;
+    if (target < node.newlines) {
+      const auto newline_offsets =
+          get_buffer(node.source).newline_offsets.get_view();
+      const Count first = first_newline_from(newline_offsets, node.start);
+      return offset + newline_offsets[first + target] - node.start + 1;
+    }
+
+    target -= node.newlines;
+    offset += node.size;
+    index = node.right;
+  }
+
+  return get_size();
+}
+
+auto Dynamic::PieceTable::get_line(Count offset) const -> Count {
+  offset = Math::min(offset, get_size());
+
+  Count line = 0;
+  Bits_32 index = root;
+  while (index) {
+    const Node& node = nodes.at(index);
+    const Node& left = nodes.at(node.left);
+    if (offset < left.total_size) {
+      index = node.left;
+      continue;
+    }
+
+    offset -= left.total_size;
+    line += left.total_newlines;
+    if (offset < node.size) {
+      return line + count_newlines(node.source, node.start, offset);
+    }
+
+    offset -= node.size;
+    line += node.newlines;
+    index = node.right;
+  }
+
+  return line;
+}
+
+auto Dynamic::PieceTable::get_depth() const -> Count {
+  return node_depth(root);
+}
+
+auto Dynamic::PieceTable::node_depth(Bits_32 index) const -> Count {
+  if (!index) {
+    return 0;
+  }
+
+  const Node& node = nodes.at(index);
+  return 1 + Math::max(node_depth(node.left), node_depth(node.right));
+}
+
+auto Dynamic::PieceTable::count_newlines(Source source, Count start, Count size)
+    const -> Count {
+  const auto newline_offsets = get_buffer(source).newline_offsets.get_view();
+  return first_newline_from(newline_offsets, start + size) -
+         first_newline_from(newline_offsets, start);
+}
+
+auto Dynamic::PieceTable::append_text(Buffer& buffer, View::Bytes text)
+    -> void {
+  if (text.get_size() == 0) {
+    return;
+  }
+
+  const Count base = buffer.bytes.get_size();
+  buffer.bytes.concat(text);
+  for (Count i = 0; i < text.get_size(); i++) {
+    if (text[i] == '\n') {
+      buffer.newline_offsets.insert(base + i);
+    }
+  }
+}
+
+auto Dynamic::PieceTable::create_node(Source source, Count start, Count size)
+    -> Bits_32 {
+  // Xorshift is plenty for treap priorities.
+  priority_state ^= priority_state << 13;
+  priority_state ^= priority_state >> 7;
+  priority_state ^= priority_state << 17;
+
+  Node node = {};
+  node.priority = Bits_32(priority_state >> 32);
+  node.source = source;
+  node.start = start;
+  node.size = size;
+  node.newlines = count_newlines(source, start, size);
+  node.total_size = node.size;
+  node.total_newlines = node.newlines;
+
+  if (free_nodes.get_size()) {
+    const Bits_32 index = free_nodes.at(free_nodes.get_size() - 1);
+    free_nodes.resize(free_nodes.get_size() - 1);
+    nodes.at(index) = node;
+    return index;
+  }
+
+  nodes.insert(node);
+  return Bits_32(nodes.get_size() - 1);
+}
+
+auto Dynamic::PieceTable::free_tree(Bits_32 index) -> void {
+  if (!index) {
+    return;
+  }
+
+  free_tree(nodes.at(index).left);
+  free_tree(nodes.at(index).right);
+  free_nodes.insert(index);
+}
+
+auto Dynamic::PieceTable::update(Bits_32 index) -> void {
+  Node& node = nodes.at(index);
+  const Node& left = nodes.at(node.left);
+  const Node& right = nodes.at(node.right);
+  node.total_size = left.total_size + node.size + right.total_size;
+  node.total_newlines =
+      left.total_newlines + node.newlines + right.total_newlines;
+}
+
+auto Dynamic::PieceTable::merge(Bits_32 lhs, Bits_32 rhs) -> Bits_32 {
+  if (!lhs || !rhs) {
+    return lhs ? lhs : rhs;
+  }
+
+  if (nodes.at(lhs).priority > nodes.at(rhs).priority) {
+    nodes.at(lhs).right = merge(nodes.at(lhs).right, rhs);
+    update(lhs);
+    return lhs;
+  }
+
+  nodes.at(rhs).left = merge(lhs, nodes.at(rhs).left);
+  update(rhs);
+  return rhs;
+}
+
+auto Dynamic::PieceTable::split(
+    Bits_32 index,
+    Count offset,
+    Bits_32& lhs,
+    Bits_32& rhs) -> void {
+  if (!index) {
+    lhs = 0;
+    rhs = 0;
+    return;
+  }
+
+  const Count left_size = nodes.at(nodes.at(index).left).total_size;
+  const Count piece_size = nodes.at(index).size;
+  if (offset <= left_size) {
+    Bits_32 left_rhs;
+    split(nodes.at(index).left, offset, lhs, left_rhs);
+    nodes.at(index).left = left_rhs;
+    update(index);
+    rhs = index;
+    return;
+  }
+
+  if (offset >= left_size + piece_size) {
+    Bits_32 right_lhs;
+    split(nodes.at(index).right, offset - left_size - piece_size, right_lhs,
+          rhs);
+    nodes.at(index).right = right_lhs;
+    update(index);
+    lhs = index;
+    return;
+  }
+
+  // The offset cuts this piece, so the tail becomes a new piece merged in
+  // front of the right subtree. It has a fresh priority so it can't simply
+  // become the subtree's parent without breaking the heap order.
+  const Count cut = offset - left_size;
+  const Node piece = nodes.at(index);
+  const Bits_32 tail =
+      create_node(piece.source, piece.start + cut, piece.size - cut);
+
+  Node& head = nodes.at(index);
+  head.size = cut;
+  head.newlines = piece.newlines - nodes.at(tail).newlines;
+  head.right = 0;
+  update(index);
+
+  lhs = index;
+  rhs = merge(tail, piece.right);
+}
+
+auto Dynamic::PieceTable::try_extend_last(
+    Bits_32 index,
+    Count size,
+    Count newlines) -> Bool {
+  if (!index) {
+    return false;
+  }
+
+  Node& node = nodes.at(index);
+  Bool extended;
+  if (node.right) {
+    extended = try_extend_last(node.right, size, newlines);
+  } else {
+    // The text was already appended so the piece has to end right before it.
+    extended = node.source == Source::Added &&
+               node.start + node.size + size == added.bytes.get_size();
+    if (extended) {
+      node.size += size;
+      node.newlines += newlines;
+    }
+  }
+
+  if (extended) {
+    update(index);
+  }
+
+  return extended;
+}
@@ -0,0 +1,154 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/math.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/vector.hpp"
+
+namespace Perimortem::Memory::Dynamic {
+
+// Editable text stored as pieces of two buffers, for documents that change a
+// little at a time (LSP incremental sync).
+//
+// The original text is copied once and never touched again, while inserted
+// text is only ever appended to a second buffer. The document is the sequence
+// of pieces pointing into either buffer, kept in a treap ordered by position
+// where every node also tracks the bytes and newlines below it. Inserts,
+// erases and line lookups are O(log n) in the number of pieces regardless of
+// the document size. Typing at the end of the last insert grows that piece
+// instead of adding a new one.
+//
+// Both buffers keep a sorted list of their newline offsets so splitting a
+// piece counts its newlines with a binary search rather than a scan.
+//
+// Text is read back in contiguous chunks with `visit`, one per piece, or
+// flattened into a `Dynamic::Bytes` with `copy`.
+class PieceTable {
+ public:
+  PieceTable();
+  PieceTable(Core::View::Bytes original);
+
+  // Replaces the whole document, dropping all edits.
+  auto reset(Core::View::Bytes original) -> void;
+
+  // Offsets past the end are clamped to the end of the document.
+  auto insert(Count offset, Core::View::Bytes text) -> void;
+  auto erase(Count offset, Count size) -> void;
+  auto replace(Count offset, Count size, Core::View::Bytes text) -> void;
+
+  // Calls `func` with each contiguous `View::Bytes` covering the range in
+  // order, without copying. The views are only valid until the next edit.
+  template <typename func_type>
+  auto visit(Count offset, Count size, func_type&& func) const -> void {
+    offset = Core::Math::min(offset, get_size());
+    size = Core::Math::min(size, get_size() - offset);
+    visit_node(root, offset, size, func);
+  }
+
+  // Appends the bytes in the range to `output`.
+  auto copy(Count offset, Count size, Dynamic::Bytes& output) const -> void;
+
+  // Offset of the first byte of a line, counting from 0. Lines past the end
+  // give the document size.
+  auto get_line_start(Count line) const -> Count;
+  // Line containing the byte at an offset, counting from 0.
+  auto get_line(Count offset) const -> Count;
+
+  // Height of the piece tree, which should stay around O(log n) in the piece
+  // count.
+  auto get_depth() const -> Count;
+
+  constexpr auto get_size() const -> Count { return nodes.at(root).total_size; }
+  constexpr auto get_line_count() const -> Count {
+    return nodes.at(root).total_newlines + 1;
+  }
+  constexpr auto get_piece_count() const -> Count {
+    return nodes.get_size() - 1 - free_nodes.get_size();
+  }
+
+ private:
+  enum class Source : Bits_8 {
+    Original,
+    Added,
+  };
+
+  // Node 0 is an empty sentinel so children never need a null check.
+  struct Node {
+    Bits_32 left;
+    Bits_32 right;
+    Bits_32 priority;
+    Source source;
+    Count start;
+    Count size;
+    Count newlines;
+    Count total_size;
+    Count total_newlines;
+  };
+
+  struct Buffer {
+    Dynamic::Bytes bytes;
+    Dynamic::Vector<Count> newline_offsets;
+  };
+
+  template <typename func_type>
+  auto visit_node(Bits_32 index, Count offset, Count size, func_type& func)
+      const -> void {
+    if (!index || !size) {
+      return;
+    }
+
+    const Node& node = nodes.at(index);
+    const Count left_size = nodes.at(node.left).total_size;
+    if (offset < left_size) {
+      const Count left_part = Core::Math::min(size, left_size - offset);
+      visit_node(node.left, offset, left_part, func);
+      offset = left_size;
+      size -= left_part;
+    }
+
+    const Count piece_offset = offset - left_size;
+    if (size && piece_offset < node.size) {
+      const Count piece_part = Core::Math::min(size, node.size - piece_offset);
+      func(get_buffer(node.source)
+               .bytes.slice(node.start + piece_offset, piece_part));
+      offset += piece_part;
+      size -= piece_part;
+    }
+
+    if (size) {
+      visit_node(node.right, offset - left_size - node.size, size, func);
+    }
+  }
+
+  constexpr auto get_buffer(Source source) const -> const Buffer& {
+    return source == Source::Original ? original : added;
+  }
+
+  auto node_depth(Bits_32 index) const -> Count;
+  auto count_newlines(Source source, Count start, Count size) const -> Count;
+  auto append_text(Buffer& buffer, Core::View::Bytes text) -> void;
+
+  auto create_node(Source source, Count start, Count size) -> Bits_32;
+  auto free_tree(Bits_32 index) -> void;
+  auto update(Bits_32 index) -> void;
+
+  auto merge(Bits_32 lhs, Bits_32 rhs) -> Bits_32;
+  // Splits a tree so the first `offset` bytes end up in `lhs`, cutting a piece
+  // in two if the offset lands inside it.
+  auto split(Bits_32 index, Count offset, Bits_32& lhs, Bits_32& rhs) -> void;
+  // Grows the last piece of a tree if it ends where the added buffer ends.
+  auto try_extend_last(Bits_32 index, Count size, Count newlines) -> Bool;
+
+  Buffer original;
+  Buffer added;
+  Dynamic::Vector<Node> nodes;
+  Dynamic::Vector<Bits_32> free_nodes;
+  Bits_32 root = 0;
+  Bits_64 priority_state = 0x9E3779B97F4A7C15;
+};
+
+}  // namespace Perimortem::Memory::Dynamic
@@ -0,0 +1,192 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/vector.hpp"
+#include "perimortem/core/access/vector.hpp"
+#include "perimortem/core/math.hpp"
+
+#include "perimortem/memory/allocator/arena.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+
+namespace Perimortem::Memory::Dynamic {
+
+// Unordered flat set of keys using the same buckets and probes as `Map`.
+//
+// The set is a `Map` with an empty value type, which `Utility::Pair` lays out
+// in zero bytes, so a slot only holds the key (and the inline hash for the
+// vector modes) instead of paying a value plus padding like `Map<key, Bool>`
+// does. 4 byte keys also drop to a 32 bit inline hash so their slots are half
+// the size of a `Map<key, Bool>` slot in every mode. 8 byte keys save half a
+// slot in Scalar mode but only a third in the vector modes since the 8 byte
+// hash stays. The map docs cover picking a vector mode and storage type.
+template <
+    typename key_type,
+    MapVectorization vector_mode = MapVectorization::Scalar,
+    Count migration_limit = 0,
+    MapStorage storage = MapStorage::Bibliotheca>
+class Set {
+ private:
+  struct Present {};
+  using Table = Map<key_type, Present, vector_mode, migration_limit, storage>;
+
+ public:
+  Set()
+    requires(storage != MapStorage::Arena)
+  {}
+
+  Set(Count inital_capacity)
+    requires(storage != MapStorage::Arena)
+      : table(inital_capacity) {}
+
+  Set(Allocator::Arena& arena)
+    requires(storage == MapStorage::Arena)
+      : table(arena) {}
+
+  Set(Allocator::Arena& arena, Count inital_capacity)
+    requires(storage == MapStorage::Arena)
+      : table(arena, inital_capacity) {}
+
+  template <Count aggregate_size>
+  constexpr Set(const key_type (&items)[aggregate_size])
+    requires(storage != MapStorage::Arena)
+      : table(aggregate_size) {
+    for (Count i = 0; i < aggregate_size; i++) {
+      insert(items[i]);
+    }
+  }
+
+  Set(const Set& rhs) = default;
+  Set(Set&& rhs) = default;
+
+  auto ensure_capacity(Count items) -> void { table.ensure_capacity(items); }
+  auto reset() -> void { table.reset(); }
+
+  // Adds a key, returning if it wasn't already in the set.
+  constexpr auto insert(const key_type& key) -> Bool {
+    const auto size = table.get_size();
+    table.at(key);
+    return table.get_size() != size;
+  }
+
+  template <typename lookup_type>
+  constexpr auto contains(const lookup_type& key) const -> Bool {
+    return table.contains(key);
+  }
+
+  // Batched `contains`, writing one result per key.
+  auto contains_batch(
+      Core::View::Vector<key_type> keys,
+      Core::Access::Vector<Bool> results) const -> void {
+    table.contains_batch(keys, results);
+  }
+
+  // Removes a key from the set, returning if the key was present.
+  //
+  // Like `Map::erase` this invalidates any outstanding iterators.
+  template <typename lookup_type>
+  constexpr auto erase(const lookup_type& key) -> Bool {
+    return table.erase(key);
+  }
+
+  // Adds every key from another set.
+  auto merge(const Set& rhs) -> void {
+    for (const auto& key : rhs) {
+      table.at(key);
+    }
+  }
+
+  // Keys in either set. The larger set is copied in one go and only the
+  // smaller one is probed.
+  static auto unite(const Set& lhs, const Set& rhs) -> Set {
+    const Bool lhs_larger = lhs.get_size() >= rhs.get_size();
+    Set result = lhs_larger ? lhs : rhs;
+    result.merge(lhs_larger ? rhs : lhs);
+
+    return result;
+  }
+
+  // Keys in both sets. The smaller set is copied and its keys are checked
+  // against the larger one using batched lookups, then the misses are erased.
+  static auto intersect(const Set& lhs, const Set& rhs) -> Set {
+    const Bool lhs_smaller = lhs.get_size() <= rhs.get_size();
+    const Set& smaller = lhs_smaller ? lhs : rhs;
+    const Set& larger = lhs_smaller ? rhs : lhs;
+    Set result = smaller;
+
+    // Keys are gathered from the original so erasing from the copy doesn't
+    // disturb the iteration. Only pointers are batched so keys that own
+    // memory aren't copied.
+    const key_type* keys[Table::batch_width];
+    typename Table::Entry* entries[Table::batch_width];
+    Count group = 0;
+    auto flush = [&]() {
+      larger.table.find_batch(
+          Core::View::Vector<const key_type*>(keys, group),
+          Core::Access::Vector<typename Table::Entry*>(entries, group));
+      for (Count i = 0; i < group; i++) {
+        if (!entries[i]) {
+          result.erase(*keys[i]);
+        }
+      }
+      group = 0;
+    };
+
+    for (const auto& key : smaller) {
+      keys[group++] = &key;
+      if (group == Table::batch_width) {
+        flush();
+      }
+    }
+    flush();
+
+    return result;
+  }
+
+  // Forward iterator over every key in bucket order.
+  class Iterator {
+   public:
+    constexpr auto operator*() const -> const key_type& {
+      return entries->key;
+    }
+
+    constexpr auto operator->() const -> const key_type* {
+      return &entries->key;
+    }
+
+    constexpr auto operator++() -> Iterator& {
+      ++entries;
+      return *this;
+    }
+
+    constexpr auto operator==(const Iterator& rhs) const -> Bool {
+      return entries == rhs.entries;
+    }
+
+    constexpr auto operator!=(const Iterator& rhs) const -> Bool {
+      return entries != rhs.entries;
+    }
+
+   private:
+    friend Set;
+
+    constexpr Iterator(typename Table::Iterator entries) : entries(entries) {}
+
+    typename Table::Iterator entries;
+  };
+
+  constexpr auto begin() const -> Iterator { return Iterator(table.begin()); }
+  constexpr auto end() const -> Iterator { return Iterator(table.end()); }
+
+  constexpr auto get_size() const -> Count { return table.get_size(); }
+  constexpr auto get_capacity() const -> Count { return table.get_capacity(); }
+  constexpr auto get_memory_consumption() const -> Count {
+    return table.get_memory_consumption();
+  }
+
+ private:
+  Table table;
+};
+
+}  // namespace Perimortem::Memory::Dynamic
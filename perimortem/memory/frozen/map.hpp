@@ -0,0 +1,292 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/data.hpp"
+#include "perimortem/core/hash.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+
+namespace Perimortem::Memory::Frozen {
+
+// Read only hash map that lives entirely inside a byte image.
+//
+// `freeze` packs any map's entries into a single position independent image
+// (every reference is an offset from the start of the image) which can be
+// written to disk as is. Opening an image only checks the header, lookups then
+// run straight out of the bytes so a table read back or `mmap`ed from disk is
+// usable without rebuilding anything.
+//
+// The image is split into:
+// * A header describing the layout.
+// * Buckets holding a 32 bit hash tag and the index of their slot. Buckets are
+//   kept at most half full so misses stop after a couple of probes, while the
+//   slots themselves stay densely packed.
+// * Slots holding the value and either the key or, for `View::Bytes` keys, the
+//   offset and size of the key's bytes.
+// * The bytes of every text key.
+//
+// Values (and non text keys) have to be trivially copyable since they are
+// stored as raw bytes. Images use the native byte order and expect to be 8
+// byte aligned, which any `mmap` or Bibliotheca block is. Only the header is
+// validated so images should come from a trusted source.
+template <typename key_type, typename value_type>
+class Map {
+  static constexpr Bool byte_keys = __is_same(key_type, Core::View::Bytes);
+
+  static_assert(
+      __is_trivially_copyable(value_type),
+      "Frozen::Map values must be trivially copyable.");
+  static_assert(
+      byte_keys || __is_trivially_copyable(key_type),
+      "Frozen::Map keys must be View::Bytes or trivially copyable.");
+
+  struct Header {
+    Bits_32 magic;
+    Bits_32 version;
+    Bits_32 key_size;
+    Bits_32 value_size;
+    Bits_64 bucket_count;
+    Bits_64 size;
+    Bits_64 buckets_offset;
+    Bits_64 slots_offset;
+    Bits_64 bytes_offset;
+    Bits_64 image_size;
+  };
+
+  struct Bucket {
+    Bits_32 tag;
+    Bits_32 slot;
+  };
+
+  struct ByteSlot {
+    Bits_32 key_offset;
+    Bits_32 key_size;
+    value_type value;
+  };
+
+  struct KeySlot {
+    key_type key;
+    value_type value;
+  };
+
+  template <bool>
+  struct SlotType {
+    using Type = KeySlot;
+  };
+
+  template <>
+  struct SlotType<true> {
+    using Type = ByteSlot;
+  };
+
+  using slot_type = SlotType<bool(byte_keys)>::Type;
+
+  static constexpr Bits_32 image_magic = 0x4D464D50;  // "PMFM"
+  // Bumped whenever `Core::Hash` changes since the tags are stored. Version 2
+  // hashes keys of `Hash::bulk_threshold` bytes or more with the bulk path,
+  // version 3 changed the numeric hash and the bulk path's stripe keys.
+  static constexpr Bits_32 image_version = 3;
+  static constexpr Count image_alignment = 8;
+
+ public:
+  Map() = default;
+  Map(Core::View::Bytes image) { open(image); }
+
+  // Pack the entries of a map into an image, replacing the contents of
+  // `image`.
+  //
+  // The source only needs `get_size` and iteration over entries with a `key`
+  // and `value`, so any `Dynamic::Map` works. Text keys can be anything that
+  // converts to a `View::Bytes`.
+  template <typename source_type>
+  static auto freeze(const source_type& source, Dynamic::Bytes& image)
+      -> void {
+    const Count size = source.get_size();
+
+    // Keep the buckets at most half full.
+    Count bucket_count = 2;
+    while (bucket_count < size * 2) {
+      bucket_count <<= 1;
+    }
+
+    Count key_bytes = 0;
+    if constexpr (byte_keys) {
+      for (const auto& entry : source) {
+        key_bytes += Core::View::Bytes(entry.key).get_size();
+      }
+    }
+
+    const Count buckets_offset =
+        Core::Data::align<image_alignment>(sizeof(Header));
+    const Count slots_offset = Core::Data::align<image_alignment>(
+        buckets_offset + sizeof(Bucket) * bucket_count);
+    const Count bytes_offset = Core::Data::align<image_alignment>(
+        slots_offset + sizeof(slot_type) * size);
+    const Count image_size = bytes_offset + key_bytes;
+
+    image.forgetful_resize(image_size);
+    image.set(0);
+    Bits_8* base = image.get_access().get_data();
+
+    Header header;
+    header.magic = image_magic;
+    header.version = image_version;
+    header.key_size = byte_keys ? 0 : Bits_32(sizeof(key_type));
+    header.value_size = sizeof(value_type);
+    header.bucket_count = bucket_count;
+    header.size = size;
+    header.buckets_offset = buckets_offset;
+    header.slots_offset = slots_offset;
+    header.bytes_offset = bytes_offset;
+    header.image_size = image_size;
+    Core::Data::copy(base, header);
+
+    auto buckets = Core::Data::cast<Bucket>(base + buckets_offset);
+    auto slots = Core::Data::cast<slot_type>(base + slots_offset);
+    Count slot_index = 0;
+    Count byte_offset = 0;
+    for (const auto& entry : source) {
+      auto& slot = slots[slot_index];
+      slot.value = entry.value;
+
+      Bits_64 hash;
+      if constexpr (byte_keys) {
+        const auto key = Core::View::Bytes(entry.key);
+        Core::Data::copy(
+            base + bytes_offset + byte_offset, key.get_data(), key.get_size());
+        slot.key_offset = Bits_32(byte_offset);
+        slot.key_size = Bits_32(key.get_size());
+        byte_offset += key.get_size();
+        hash = get_hash(key);
+      } else {
+        slot.key = entry.key;
+        hash = get_hash(slot.key);
+      }
+
+      // Every key is unique so the first empty bucket is the one to use.
+      Count bi = hash & (bucket_count - 1);
+      while (buckets[bi].tag) {
+        bi = (bi + 1) & (bucket_count - 1);
+      }
+      buckets[bi].tag = extract_tag(hash);
+      buckets[bi].slot = Bits_32(slot_index);
+
+      slot_index++;
+    }
+  }
+
+  // Point the map at an image, returning if the image is usable. The image
+  // has to outlive the map.
+  auto open(Core::View::Bytes image) -> Bool {
+    *this = Map();
+    if (image.get_size() < sizeof(Header) ||
+        Count(image.get_data()) % image_alignment) {
+      return false;
+    }
+
+    const auto header = Core::Data::cast<Header>(image.get_data());
+    if (header->magic != image_magic || header->version != image_version ||
+        header->key_size != (byte_keys ? 0 : sizeof(key_type)) ||
+        header->value_size != sizeof(value_type) ||
+        header->image_size > image.get_size()) {
+      return false;
+    }
+
+    // The bucket count has to be a power of 2 with room to spare for probes to
+    // end, and every section has to fit in the image.
+    const auto bucket_count = header->bucket_count;
+    if (bucket_count < 2 || (bucket_count & (bucket_count - 1)) ||
+        header->size >= bucket_count ||
+        header->buckets_offset + sizeof(Bucket) * bucket_count >
+            header->slots_offset ||
+        header->slots_offset + sizeof(slot_type) * header->size >
+            header->bytes_offset ||
+        header->bytes_offset > header->image_size) {
+      return false;
+    }
+
+    const Bits_8* base = image.get_data();
+    buckets = Core::Data::cast<Bucket>(base + header->buckets_offset);
+    slots = Core::Data::cast<slot_type>(base + header->slots_offset);
+    bytes = base + header->bytes_offset;
+    bucket_mask = bucket_count - 1;
+    size = header->size;
+
+    return true;
+  }
+
+  // Get the value for a key if it exists. The pointer points into the image.
+  template <typename lookup_type>
+  constexpr auto find(const lookup_type& key) const -> const value_type* {
+    if (!buckets) {
+      return nullptr;
+    }
+
+    Bits_64 hash;
+    if constexpr (byte_keys) {
+      hash = get_hash(Core::View::Bytes(key));
+    } else {
+      hash = get_hash(key_type(key));
+    }
+
+    const auto tag = extract_tag(hash);
+    Count bi = hash & bucket_mask;
+    while (buckets[bi].tag) {
+      if (buckets[bi].tag == tag) {
+        const auto& slot = slots[buckets[bi].slot];
+        if constexpr (byte_keys) {
+          const auto stored =
+              Core::View::Bytes(bytes + slot.key_offset, slot.key_size);
+          if (stored == Core::View::Bytes(key)) {
+            return &slot.value;
+          }
+        } else if (slot.key == key_type(key)) {
+          return &slot.value;
+        }
+      }
+
+      bi = (bi + 1) & bucket_mask;
+    }
+
+    return nullptr;
+  }
+
+  template <typename lookup_type>
+  constexpr auto contains(const lookup_type& key) const -> Bool {
+    return find(key) != nullptr;
+  }
+
+  template <typename lookup_type>
+  constexpr auto find_or_default(
+      const lookup_type& key,
+      const value_type& value) const -> const value_type& {
+    auto found = find(key);
+    return found ? *found : value;
+  }
+
+  constexpr auto is_valid() const -> Bool { return buckets != nullptr; }
+  constexpr auto get_size() const -> Count { return size; }
+
+ private:
+  static constexpr auto get_hash(const key_type& key) -> Bits_64 {
+    Core::Hash h(key);
+    return h.get_value();
+  }
+
+  // The index comes from the low bits so the tag uses the high ones, with the
+  // top bit set so a tag is never 0.
+  static constexpr auto extract_tag(Bits_64 hash) -> Bits_32 {
+    return Bits_32(hash >> 32) | Bits_32(0x80000000);
+  }
+
+  const Bucket* buckets = nullptr;
+  const slot_type* slots = nullptr;
+  const Bits_8* bytes = nullptr;
+  Count bucket_mask = 0;
+  Count size = 0;
+};
+
+}  // namespace Perimortem::Memory::Frozen
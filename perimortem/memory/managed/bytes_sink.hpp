@@ -0,0 +1,34 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/math.hpp"
+#include "perimortem/core/writer/sink.hpp"
+
+#include "perimortem/memory/managed/bytes.hpp"
+
+namespace Perimortem::Memory::Managed {
+
+// Lets a writer grow a Managed::Bytes as it goes rather than sizing the
+// output ahead of time. Writing starts at the front of the bytes.
+//
+// The bytes are grown geometrically and handed over at full capacity, so
+// they're usually larger than what was written. Resize them to the writer's
+// get_location() once done. Old blocks stay in the arena until it's reset.
+class BytesSink : public Core::Writer::Sink {
+ public:
+  BytesSink(Managed::Bytes& target) : target(target) {}
+
+  auto grow(Count required) -> Core::Access::Bytes override {
+    // Capacity already grows geometrically, so take all of it.
+    target.ensure_capacity(required);
+    target.resize(target.get_capacity());
+    return target.get_access();
+  }
+
+ private:
+  Managed::Bytes& target;
+};
+
+}  // namespace Perimortem::Memory::Managed
@@ -0,0 +1,114 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/memory/shared/bytes.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/data.hpp"
+#include "perimortem/core/math.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+Shared::Bytes::Bytes(Core::View::Bytes view) : size(view.get_size()) {
+  if (view.get_size() == 0) {
+    return;
+  }
+
+  auto alloc = Bibliotheca::check_out(view.get_size());
+  block = alloc.ptr;
+  data = block;
+  Data::copy(block, view.get_data(), view.get_size());
+}
+
+Shared::Bytes::Bytes(Dynamic::Bytes&& bytes) {
+  if (bytes.get_size() == 0) {
+    bytes.reset();
+    return;
+  }
+
+  if (bytes.is_inline()) {
+    *this = Bytes(bytes.get_view());
+    bytes.reset();
+    return;
+  }
+
+  // The reservation from the check out moves over with the block.
+  block = bytes.heap.block;
+  data = block;
+  size = bytes.heap.size;
+  bytes.local.tag = Dynamic::Bytes::inline_flag;
+}
+
+Shared::Bytes::Bytes(const Bytes& rhs)
+    : block(rhs.block), data(rhs.data), size(rhs.size) {
+  if (block) {
+    Bibliotheca::reserve(block);
+  }
+}
+
+Shared::Bytes::Bytes(Bytes&& rhs)
+    : block(rhs.block), data(rhs.data), size(rhs.size) {
+  rhs.block = nullptr;
+  rhs.data = nullptr;
+  rhs.size = 0;
+}
+
+auto Shared::Bytes::operator=(const Bytes& rhs) -> Bytes& {
+  // Reserve first in case both share the block and we're the last owner.
+  if (rhs.block) {
+    Bibliotheca::reserve(rhs.block);
+  }
+
+  reset();
+  block = rhs.block;
+  data = rhs.data;
+  size = rhs.size;
+
+  return *this;
+}
+
+auto Shared::Bytes::operator=(Bytes&& rhs) -> Bytes& {
+  if (this == &rhs) {
+    return *this;
+  }
+
+  reset();
+  Data::swap(block, rhs.block);
+  Data::swap(data, rhs.data);
+  Data::swap(size, rhs.size);
+
+  return *this;
+}
+
+Shared::Bytes::~Bytes() {
+  reset();
+}
+
+auto Shared::Bytes::slice(Count start, Count size) const -> Bytes {
+  Bytes result;
+  if (start >= get_size()) {
+    return result;
+  }
+
+  Bibliotheca::reserve(block);
+  result.block = block;
+  result.data = data + start;
+  result.size = Math::min(size, get_size() - start);
+
+  return result;
+}
+
+auto Shared::Bytes::reset() -> void {
+  if (block) {
+    Bibliotheca::remit(block);
+  }
+
+  block = nullptr;
+  data = nullptr;
+  size = 0;
+}
+
+auto Shared::Bytes::get_owner_count() const -> Count {
+  return block ? Bibliotheca::reservations(block) : 0;
+}
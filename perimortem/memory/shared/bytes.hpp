@@ -0,0 +1,78 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/hash.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+
+namespace Perimortem::Memory::Shared {
+
+// Read only bytes that share ownership of a Bibliotheca block.
+//
+// Every `Bytes` is a slice of a block along with a reservation on it, so
+// copying or slicing only bumps the block's reservation count and the block
+// goes back to the Bibliotheca when the last owner remits it. This lets a
+// decoded buffer (file contents, an inflated archive block) be split into
+// pieces that are handed to parsers without copying or tracking who finishes
+// last.
+//
+// Reservations aren't atomic so owners of one block have to stay on a single
+// thread.
+class Bytes {
+ public:
+  Bytes() = default;
+  // Copies the view into a new block.
+  Bytes(Core::View::Bytes view);
+  // Takes over the block of a `Dynamic::Bytes`. Inline bytes are copied into
+  // a new block.
+  Bytes(Dynamic::Bytes&& bytes);
+  Bytes(const Shared::Bytes& rhs);
+  Bytes(Shared::Bytes&& rhs);
+
+  auto operator=(const Shared::Bytes& rhs) -> Shared::Bytes&;
+  auto operator=(Shared::Bytes&& rhs) -> Shared::Bytes&;
+
+  auto operator==(const Shared::Bytes& rhs) const -> Bool {
+    return get_view() == rhs.get_view();
+  }
+
+  auto operator==(const Core::View::Bytes& rhs) const -> Bool {
+    return get_view() == rhs;
+  }
+
+  ~Bytes();
+
+  constexpr operator Core::View::Bytes() const { return get_view(); }
+
+  // A new owner of part of the same block. Like `View::Bytes::slice` the
+  // range is clamped to the bytes available.
+  auto slice(Count start, Count size) const -> Shared::Bytes;
+
+  // Drops this owner's reservation, leaving it empty.
+  auto reset() -> void;
+
+  constexpr auto get_size() const -> Count { return size; }
+  constexpr auto get_view() const -> const Core::View::Bytes {
+    return Core::View::Bytes(data, size);
+  }
+
+  // Number of owners of the underlying block, 0 if there isn't one.
+  auto get_owner_count() const -> Count;
+
+  constexpr auto hash() const -> Bits_64 {
+    return Core::Hash(get_view()).get_value();
+  }
+
+  constexpr auto is_empty() const -> Bool { return size == 0; }
+
+ private:
+  // The start of the block is kept separately since remitting needs it.
+  Bits_8* block = nullptr;
+  const Bits_8* data = nullptr;
+  Count size = 0;
+};
+
+}  // namespace Perimortem::Memory::Shared
@@ -6,9 +6,11 @@
 #include <x86intrin.h>
 
 #include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/reader/textual.hpp"
 #include "perimortem/core/writer/textual.hpp"
 
 #include "perimortem/memory/managed/bytes.hpp"
+#include "perimortem/memory/managed/bytes_sink.hpp"
 #include "perimortem/memory/managed/vector.hpp"
 
 enum class NodeState : Bits_32 {
@@ -489,41 +491,33 @@ auto Json::Node::parse(
     // Numbers
     case '-':
     case '0' ... '9': {
-      Bool positive = True;
-      if (source[position] == '-') {
-        positive = False;
-        position++;
-      }
-
-      Signed_64 value = 0;
-      while (position < source.get_size() && source[position] >= '0' &&
-             source[position] <= '9') {
-        value *= 10;
-        value += source[position] - '0';
-        position++;
-      }
+      Reader::Textual reader(source);
+      reader.set_pointer(position);
+      const Signed_64 value = reader.read_signed();
+      const Count end = reader.get_location();
+
+      // Fractions and exponents go back over the whole number so the real
+      // is rounded correctly from every digit instead of built up in steps.
+      if (end < source.get_size() &&
+          (source[end] == '.' || source[end] == 'e' || source[end] == 'E')) {
+        reader.set_pointer(position);
+        const Real_64 real = reader.read_real_64();
+        if (!reader.is_valid()) {
+          set();
+          return Count(-1);
+        }
 
-      if (position >= source.get_size() || source[position] != '.') {
-        set(value * positive.sign());
-        return position;
+        set(real);
+        return reader.get_location();
       }
 
-      position++;  // consume '.'
-      Real_64 float_value = value;
-      Bits_64 divisor = 1;
-
-      // Try to perserve precision by using fixed point and only convert into
-      // floating point once.
-      while (position < source.get_size() && source[position] >= '0' &&
-             source[position] <= '9') {
-        float_value *= 10;
-        divisor *= 10;
-        float_value += source[position] - '0';
-        position++;
+      if (!reader.is_valid()) {
+        set();
+        return Count(-1);
       }
 
-      set((float_value / Real_64(divisor)) * positive.sign());
-      return position;
+      set(value);
+      return end;
     }
 
     // null
@@ -551,88 +545,11 @@ auto Json::Node::parse(
   return position;
 }
 
-auto Json::Node::serialized_size() const -> Count {
-  switch ((NodeState)data.state) {
-  case NodeState::Null: {
-    return "null"_view.get_size();
-  }
-
-  case NodeState::Array: {
-    Count accumulated = 0;
-    View::Vector<Json::Node> array = get_array();
-    for (Bits_32 i = 0; i < array.get_size(); i++) {
-      accumulated += array[i].serialized_size();
-    }
-
-    const auto number_of_commas = array.get_size() - 1;
-    return accumulated + "[]"_view.get_size() + number_of_commas;
-  }
-
-  case NodeState::Object: {
-    Count accumulated = 0;
-    View::Vector<Member> members = get_object();
-    for (Bits_32 i = 0; i < members.get_size(); i++) {
-      const auto& member = members[i];
-      accumulated += member.name.get_size() + "\"\":"_view.get_size();
-      accumulated += member.node.serialized_size();
-    }
-
-    const auto number_of_commas = members.get_size() - 1;
-    return accumulated + "{}"_view.get_size() + number_of_commas;
-  }
-
-  case NodeState::String: {
-    auto length = get_size();
-    return length + "\"\""_view.get_size();
-  }
-
-  case NodeState::Flag: {
-    if (data.flag) {
-      return "true"_view.get_size();
-    } else {
-      return "false"_view.get_size();
-    }
-  }
-
-  case NodeState::Number: {
-    Count accumulated = 0;
-    auto number = data.number;
-    if (number == 0) {
-      return accumulated + 1;
-    }
-
-    // Include space for the negative sign.
-    if (number < 0) {
-      accumulated += 1;
-      number = number * -1;
-    }
-
-    // Slightly overestimates number of digits by computing log8(number) of
-    // the number and rounding up.
-    // Only overestimates by 1 byte for any value upto 10^9 an only 2 bytes
-    // for the entire 64 bit range, compared to the div 10 version.
-    while (number > 0) {
-      number >>= 3;
-      accumulated += 1;
-    }
-
-    return accumulated;
-  }
-
-  // Assume 32 bytes is sufficient
-  case NodeState::Real: {
-    return 32;
-  }
-  }
-}
-
 auto Json::Node::format(Allocator::Arena& arena) const -> View::Bytes {
-  // Get an upper bound which should be fairly accurate but can be pessemsitic
-  // in the case of a large number of reals.
-  Count upper_bound = serialized_size();
+  // Format in a single pass, growing the output as it fills up.
   Managed::Bytes formatted_output(arena);
-  formatted_output.resize(upper_bound);
-  Writer::Textual output(formatted_output.get_access());
+  Managed::BytesSink sink(formatted_output);
+  Writer::Textual output(sink);
 
   auto inplace_format = [](this auto&& self, Writer::Textual& output,
                            const Json::Node& node) -> void {
@@ -691,6 +608,13 @@ auto Json::Node::format(Allocator::Arena& arena) const -> View::Bytes {
     }
 
     case NodeState::Real: {
+      // JSON has no spelling for nan or infinity, so write them as null the
+      // same way browsers do rather than emit a document nothing can parse.
+      if (!__builtin_isfinite(node.data.real)) {
+        output << "null"_view;
+        return;
+      }
+
       output << node.data.real;
       return;
     }
@@ -700,8 +624,7 @@ auto Json::Node::format(Allocator::Arena& arena) const -> View::Bytes {
   // Start the format chain.
   inplace_format(output, *this);
 
-  // If we went over the buffer or if we failed to format the data return an
-  // empty view.
+  // If we failed to format the data return an empty view.
   if (!output.is_valid()) {
     return View::Bytes();
   }
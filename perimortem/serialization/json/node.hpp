@@ -102,8 +102,6 @@ class Node {
   auto format(Memory::Allocator::Arena& arena) const -> Core::View::Bytes;
 
  private:
-  auto serialized_size() const -> Count;
-
   struct {
     union {
       const void* ptr;
@@ -0,0 +1,434 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#pragma once
+
+#include "perimortem/core/algorithm/byte_swap.hpp"
+#include "perimortem/core/access/bytes.hpp"
+#include "perimortem/core/data.hpp"
+#include "perimortem/core/reader/binary.hpp"
+#include "perimortem/core/reader/serial.hpp"
+#include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/writer/binary.hpp"
+#include "perimortem/core/writer/serial.hpp"
+
+namespace Perimortem::Serialization {
+
+// List of the members of a type to persist, in the order they're stored.
+// Declared once per type by specializing Schema:
+//
+//   template <>
+//   struct Schema<Player> : Fields<&Player::id, &Player::position> {};
+template <auto... members>
+struct Fields {
+  static constexpr Count field_count = sizeof...(members);
+
+  template <typename object_type, typename visitor_type>
+  static constexpr auto for_each(object_type& object, visitor_type&& visitor)
+      -> void {
+    (visitor(object.*members), ...);
+  }
+};
+
+// Specialize for each persisted type, see Fields.
+template <typename type>
+struct Schema;
+
+template <typename type>
+concept Schematic = requires { Schema<type>::field_count; };
+
+// Fixed width numbers, stored the same way Binary reads and writes them.
+template <typename type>
+concept Scalar =
+    __is_same(type, Bits_8) || __is_same(type, Bits_16) ||
+    __is_same(type, Bits_32) || __is_same(type, Bits_64) ||
+    __is_same(type, Signed_8) || __is_same(type, Signed_16) ||
+    __is_same(type, Signed_32) || __is_same(type, Signed_64) ||
+    __is_same(type, Real_32) || __is_same(type, Real_64);
+
+// Encodes and decodes Schematic types field by field with either the Binary
+// or Serial formats, so the layout of a type only has to be written once.
+//
+// Fields can be any Scalar, Bool, View::Bytes, another Schematic type or a
+// Static::Vector of any of those. No names or tags are stored so readers have
+// to use the same Schema (and for Binary the same byte order) as the writer.
+//
+// Arrays of numbers skip the per element encoding:
+// * Binary copies them in one pass, only swapping bytes for a foreign order.
+// * Serial packs integers into a single blob of LEB128 varints (zigzagged when
+//   signed) and stores reals as a blob of their little endian bytes.
+//
+// Decoded View::Bytes point into the reader's source, so like any other view
+// read from it they only live as long as the source (or stream window) does.
+//
+// Reads return False and leave the remaining fields untouched on the first
+// failure, which includes a stored value not fitting in its field.
+class Structured {
+ public:
+  template <Core::Data::ByteOrder endian, Schematic type>
+  static auto write(Core::Writer::Binary<endian>& writer, const type& value)
+      -> Bool {
+    encode(writer, value);
+    return writer.is_valid();
+  }
+
+  template <Schematic type>
+  static auto write(Core::Writer::Serial& writer, const type& value) -> Bool {
+    encode(writer, value);
+    return writer.is_valid();
+  }
+
+  template <Core::Data::ByteOrder endian, Schematic type>
+  static auto read(Core::Reader::Binary<endian>& reader, type& value) -> Bool {
+    return decode(reader, value) & reader.is_valid();
+  }
+
+  template <Schematic type>
+  static auto read(Core::Reader::Serial& reader, type& value) -> Bool {
+    return decode(reader, value) & reader.is_valid();
+  }
+
+ private:
+  static constexpr Count varint_max_size = 10;
+
+  template <typename writer_type, Schematic type>
+  static auto encode(writer_type& writer, const type& value) -> void {
+    Schema<type>::for_each(
+        value, [&](const auto& field) { encode(writer, field); });
+  }
+
+  template <typename reader_type, Schematic type>
+  static auto decode(reader_type& reader, type& value) -> Bool {
+    Bool valid = True;
+    Schema<type>::for_each(value, [&](auto& field) {
+      // Stop at the first failure rather than reading garbage into the rest.
+      if (valid) {
+        valid = decode(reader, field) & reader.is_valid();
+      }
+    });
+    return valid;
+  }
+
+  //
+  // Binary
+  //
+
+  template <Core::Data::ByteOrder endian, Scalar type>
+  static auto encode(Core::Writer::Binary<endian>& writer, const type value)
+      -> void {
+    writer << value;
+  }
+
+  template <Core::Data::ByteOrder endian>
+  static auto encode(Core::Writer::Binary<endian>& writer, const Bool value)
+      -> void {
+    writer << Bits_8(value ? 1 : 0);
+  }
+
+  template <Core::Data::ByteOrder endian>
+  static auto encode(
+      Core::Writer::Binary<endian>& writer, const Core::View::Bytes value)
+      -> void {
+    writer << Bits_64(value.get_size()) << value;
+  }
+
+  template <Core::Data::ByteOrder endian, typename type, Count size>
+  static auto encode(
+      Core::Writer::Binary<endian>& writer,
+      const Core::Static::Vector<type, size>& values) -> void {
+    if constexpr (Scalar<type>) {
+      writer << values.get_view();
+    } else {
+      for (Count i = 0; i < size; i++) {
+        encode(writer, values[i]);
+      }
+    }
+  }
+
+  template <Core::Data::ByteOrder endian, Scalar type>
+  static auto decode(Core::Reader::Binary<endian>& reader, type& value)
+      -> Bool {
+    if constexpr (__is_same(type, Bits_8)) {
+      value = reader.read_bits_8();
+    } else if constexpr (__is_same(type, Bits_16)) {
+      value = reader.read_bits_16();
+    } else if constexpr (__is_same(type, Bits_32)) {
+      value = reader.read_bits_32();
+    } else if constexpr (__is_same(type, Bits_64)) {
+      value = reader.read_bits_64();
+    } else if constexpr (__is_same(type, Signed_8)) {
+      value = reader.read_signed_bits_8();
+    } else if constexpr (__is_same(type, Signed_16)) {
+      value = reader.read_signed_bits_16();
+    } else if constexpr (__is_same(type, Signed_32)) {
+      value = reader.read_signed_bits_32();
+    } else if constexpr (__is_same(type, Signed_64)) {
+      value = reader.read_signed_bits_64();
+    } else if constexpr (__is_same(type, Real_32)) {
+      value = reader.read_real_32();
+    } else {
+      value = reader.read_real_64();
+    }
+
+    return reader.is_valid();
+  }
+
+  template <Core::Data::ByteOrder endian>
+  static auto decode(Core::Reader::Binary<endian>& reader, Bool& value)
+      -> Bool {
+    const Bits_8 stored = reader.read_bits_8();
+    value = stored != 0;
+    return reader.is_valid() & (stored <= 1);
+  }
+
+  template <Core::Data::ByteOrder endian>
+  static auto decode(
+      Core::Reader::Binary<endian>& reader, Core::View::Bytes& value) -> Bool {
+    const Count size = reader.read_bits_64();
+    if (!reader.is_valid() || size > reader.get_size()) {
+      return False;
+    }
+
+    value = reader.read_bytes(size);
+    return reader.is_valid();
+  }
+
+  template <Core::Data::ByteOrder endian, typename type, Count size>
+  static auto decode(
+      Core::Reader::Binary<endian>& reader,
+      Core::Static::Vector<type, size>& values) -> Bool {
+    if constexpr (Scalar<type>) {
+      return reader.read_array(values.get_access());
+    } else {
+      for (Count i = 0; i < size; i++) {
+        if (!decode(reader, values[i])) {
+          return False;
+        }
+      }
+
+      return True;
+    }
+  }
+
+  //
+  // Serial
+  //
+
+  // Serial values are always 64 bit, so reals are stored as their bit pattern
+  // and everything narrower is range checked on the way back in.
+  template <Scalar type>
+  static auto encode(Core::Writer::Serial& writer, const type value) -> void {
+    if constexpr (__is_same(type, Real_32)) {
+      Bits_32 bits;
+      Core::Data::copy(Core::Data::cast<Bits_8>(&bits), &value);
+      writer << Bits_64(bits);
+    } else if constexpr (__is_same(type, Real_64)) {
+      Bits_64 bits;
+      Core::Data::copy(Core::Data::cast<Bits_8>(&bits), &value);
+      writer << bits;
+    } else {
+      writer << Bits_64(value);
+    }
+  }
+
+  static auto encode(Core::Writer::Serial& writer, const Bool value) -> void {
+    writer << Bits_64(value ? 1 : 0);
+  }
+
+  static auto encode(
+      Core::Writer::Serial& writer, const Core::View::Bytes value) -> void {
+    writer << value;
+  }
+
+  template <typename type, Count size>
+  static auto encode(
+      Core::Writer::Serial& writer,
+      const Core::Static::Vector<type, size>& values) -> void {
+    if constexpr (Scalar<type> && sizeof(type) == 1) {
+      writer << Core::View::Bytes(
+          Core::Data::cast<const Bits_8>(values.get_data()), size);
+    } else if constexpr (
+        __is_same(type, Real_32) || __is_same(type, Real_64)) {
+      Core::Access::Bytes blob = writer.reserve_blob(size * sizeof(type));
+      if (blob.get_size() == size * sizeof(type)) {
+        copy_little_endian<sizeof(type)>(
+            blob.get_data(), Core::Data::cast<const Bits_8>(values.get_data()),
+            size);
+      }
+    } else if constexpr (Scalar<type>) {
+      Count packed_size = 0;
+      for (Count i = 0; i < size; i++) {
+        packed_size += varint_size(zigzag(values[i]));
+      }
+
+      Core::Access::Bytes blob = writer.reserve_blob(packed_size);
+      if (blob.get_size() == packed_size) {
+        Bits_8* output = blob.get_data();
+        for (Count i = 0; i < size; i++) {
+          output = write_varint(output, zigzag(values[i]));
+        }
+      }
+    } else {
+      for (Count i = 0; i < size; i++) {
+        encode(writer, values[i]);
+      }
+    }
+  }
+
+  template <Scalar type>
+  static auto decode(Core::Reader::Serial& reader, type& value) -> Bool {
+    const Signed_64 stored = reader.read_value();
+    if constexpr (__is_same(type, Real_32)) {
+      const Bits_32 bits = Bits_32(stored);
+      Core::Data::copy(Core::Data::cast<Bits_8>(&value), &bits);
+      return reader.is_valid() & (Signed_64(bits) == stored);
+    } else if constexpr (__is_same(type, Real_64)) {
+      Core::Data::copy(Core::Data::cast<Bits_8>(&value), &stored);
+      return reader.is_valid();
+    } else {
+      value = type(stored);
+      return reader.is_valid() & (Signed_64(value) == stored);
+    }
+  }
+
+  static auto decode(Core::Reader::Serial& reader, Bool& value) -> Bool {
+    const Signed_64 stored = reader.read_value();
+    value = stored != 0;
+    return reader.is_valid() & (stored == 0 || stored == 1);
+  }
+
+  static auto decode(Core::Reader::Serial& reader, Core::View::Bytes& value)
+      -> Bool {
+    auto stored = reader.read();
+    value = stored.get_view();
+    return reader.is_valid() & stored.is_blob();
+  }
+
+  template <typename type, Count size>
+  static auto decode(
+      Core::Reader::Serial& reader, Core::Static::Vector<type, size>& values)
+      -> Bool {
+    if constexpr (Scalar<type> && (sizeof(type) == 1 ||
+                                   __is_same(type, Real_32) ||
+                                   __is_same(type, Real_64))) {
+      const Core::View::Bytes blob = reader.read_blob();
+      if (!reader.is_valid() || blob.get_size() != size * sizeof(type)) {
+        return False;
+      }
+
+      copy_little_endian<sizeof(type)>(
+          Core::Data::cast<Bits_8>(values.get_data()), blob.get_data(), size);
+      return True;
+    } else if constexpr (Scalar<type>) {
+      const Core::View::Bytes blob = reader.read_blob();
+      if (!reader.is_valid()) {
+        return False;
+      }
+
+      const Bits_8* input = blob.get_data();
+      const Bits_8* end = input + blob.get_size();
+      for (Count i = 0; i < size; i++) {
+        Bits_64 packed;
+        input = read_varint(input, end, packed);
+        if (!input) {
+          return False;
+        }
+
+        const Signed_64 stored = unzigzag<type>(packed);
+        values[i] = type(stored);
+        if (Signed_64(values[i]) != stored) {
+          return False;
+        }
+      }
+
+      // Anything left over means the array was written with a different size.
+      return input == end;
+    } else {
+      for (Count i = 0; i < size; i++) {
+        if (!decode(reader, values[i])) {
+          return False;
+        }
+      }
+
+      return True;
+    }
+  }
+
+  // Serial blobs are little endian regardless of the host.
+  template <Count width>
+  static auto copy_little_endian(
+      Bits_8* dest, const Bits_8* source, Count count) -> void {
+    if constexpr (
+        width == 1 ||
+        Core::Data::ByteOrder::Native == Core::Data::ByteOrder::Little) {
+      Core::Data::copy(dest, source, count * width);
+    } else {
+      Core::Algorithm::copy_swapped<width>(dest, source, count);
+    }
+  }
+
+  // Folds the sign into the low bit so small negative numbers stay short.
+  // Unsigned values are stored as is.
+  template <Scalar type>
+  static constexpr auto zigzag(const type value) -> Bits_64 {
+    if constexpr (type(-1) < type(0)) {
+      return (Bits_64(value) << 1) ^ Bits_64(Signed_64(value) >> 63);
+    } else {
+      return Bits_64(value);
+    }
+  }
+
+  template <Scalar type>
+  static constexpr auto unzigzag(const Bits_64 packed) -> Signed_64 {
+    if constexpr (type(-1) < type(0)) {
+      return Signed_64(packed >> 1) ^ -Signed_64(packed & 1);
+    } else {
+      return Signed_64(packed);
+    }
+  }
+
+  static constexpr auto varint_size(Bits_64 value) -> Count {
+    Count size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      size++;
+    }
+
+    return size;
+  }
+
+  static constexpr auto write_varint(Bits_8* output, Bits_64 value)
+      -> Bits_8* {
+    while (value >= 0x80) {
+      *output++ = Bits_8(value | 0x80);
+      value >>= 7;
+    }
+
+    *output++ = Bits_8(value);
+    return output;
+  }
+
+  // Returns the byte after the varint, or null if it runs past `end` or is
+  // longer than any 64 bit value.
+  static constexpr auto read_varint(
+      const Bits_8* input, const Bits_8* end, Bits_64& value)
+      -> const Bits_8* {
+    value = 0;
+    for (Count shift = 0; shift < varint_max_size * 7; shift += 7) {
+      if (input == end) {
+        return nullptr;
+      }
+
+      const Bits_8 byte = *input++;
+      value |= Bits_64(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return input;
+      }
+    }
+
+    return nullptr;
+  }
+};
+
+}  // namespace Perimortem::Serialization
@@ -279,3 +279,155 @@ auto File::exists(Core::View::Bytes location) -> Bool {
 auto File::update_modified_time() -> void {
   modified_time = Time::clock().get_stamp();
 }
+
+#ifdef PERI_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Reads as much of [offset, offset + count) as the file has, retrying on
+// interrupts and short reads. Returns how many bytes were read.
+static auto read_at(Signed_32 handle, Bits_8* dest, Count offset, Count count)
+    -> Count {
+  Count total = 0;
+  while (total < count) {
+    const auto result = pread64(handle, dest + total, count - total,
+                                Signed_64(offset + total));
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (result <= 0) {
+      break;
+    }
+
+    total += Count(result);
+  }
+
+  return total;
+}
+
+FileStream::FileStream(View::Bytes location, Count window_size) {
+  Bits_8 path_buffer[max_path_size];
+  const auto path = create_path(path_buffer, location);
+
+  auto file_status = get_file_status(path);
+  if (!file_status.is_file) {
+    return;
+  }
+
+  handle = open64(path, O_RDONLY | O_CLOEXEC);
+  if (handle < 0) {
+    return;
+  }
+
+  size = file_status.size_in_bytes;
+  buffer.forgetful_resize(Math::max<Count>(window_size, 1));
+  posix_fadvise64(handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+FileStream::~FileStream() {
+  if (handle >= 0) {
+    close(handle);
+  }
+}
+
+auto FileStream::fetch(Count offset, Count minimum) -> View::Bytes {
+  if (handle < 0 || offset >= size) {
+    return View::Bytes();
+  }
+
+  // Serve the request from the buffer if it's all there already.
+  const Count wanted = Math::min(minimum, size - offset);
+  if (offset >= buffer_offset &&
+      offset + wanted <= buffer_offset + buffer_fill) {
+    return buffer.slice(offset - buffer_offset,
+                        buffer_offset + buffer_fill - offset);
+  }
+
+  // Keep whatever tail of the old buffer overlaps the new one so the reader
+  // doesn't pay to read it twice.
+  auto data = buffer.get_access().get_data();
+  Count kept = 0;
+  if (offset >= buffer_offset && offset < buffer_offset + buffer_fill) {
+    kept = buffer_offset + buffer_fill - offset;
+    memmove(data, data + (offset - buffer_offset), kept);
+  }
+
+  const Count capacity = Math::min(buffer.get_size(), size - offset);
+  buffer_offset = offset;
+  buffer_fill = kept + read_at(handle, data + kept, offset + kept,
+                               capacity - kept);
+  return buffer.slice(0, buffer_fill);
+}
+
+MappedStream::MappedStream(View::Bytes location, Count window_size)
+    : window_size(window_size) {
+  Bits_8 path_buffer[max_path_size];
+  const auto path = create_path(path_buffer, location);
+
+  auto file_status = get_file_status(path);
+  if (!file_status.is_file) {
+    return;
+  }
+
+  handle = open64(path, O_RDONLY | O_CLOEXEC);
+  if (handle < 0) {
+    return;
+  }
+
+  size = file_status.size_in_bytes;
+}
+
+MappedStream::~MappedStream() {
+  unmap();
+  if (handle >= 0) {
+    close(handle);
+  }
+}
+
+auto MappedStream::unmap() -> void {
+  if (mapping) {
+    munmap(mapping, mapping_size);
+  }
+
+  mapping = nullptr;
+  mapping_offset = 0;
+  mapping_size = 0;
+}
+
+auto MappedStream::fetch(Count offset, Count minimum) -> View::Bytes {
+  if (handle < 0 || offset >= size) {
+    return View::Bytes();
+  }
+
+  const Count wanted = Math::min(minimum, size - offset);
+  if (mapping && offset >= mapping_offset &&
+      offset + wanted <= mapping_offset + mapping_size) {
+    return View::Bytes(mapping + (offset - mapping_offset),
+                       mapping_offset + mapping_size - offset);
+  }
+
+  unmap();
+
+  // Mappings have to start on a page boundary so round the offset down and
+  // map enough past it to cover the request.
+  const Count page_size = Count(sysconf(_SC_PAGESIZE));
+  const Count start = offset - offset % page_size;
+  const Count length =
+      Math::min(Math::max(window_size, offset - start + wanted), size - start);
+
+  auto result = mmap64(nullptr, length, PROT_READ, MAP_PRIVATE, handle,
+                       Signed_64(start));
+  if (result == MAP_FAILED) {
+    return View::Bytes();
+  }
+
+  madvise(result, length, MADV_SEQUENTIAL);
+  mapping = static_cast<Bits_8*>(result);
+  mapping_offset = start;
+  mapping_size = length;
+  return View::Bytes(mapping + (offset - start), length - (offset - start));
+}
+#endif
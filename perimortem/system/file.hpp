@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "perimortem/core/reader/stream.hpp"
 #include "perimortem/core/view/bytes.hpp"
 
 #include "perimortem/memory/dynamic/bytes.hpp"
@@ -71,4 +72,58 @@ class File {
   Bits_64 modified_time = 0;
 };
 
+// The streams are built on POSIX file descriptors and mmap, so they only exist
+// on platforms that provide them.
+#ifdef PERI_LINUX
+// Streams a file on disk through a fixed size buffer rather than reading it
+// into memory all at once. Refills slide the buffer forward, keeping any bytes
+// the reader still needs and reading the rest from the file, while the kernel
+// reads ahead since access is expected to be sequential.
+class FileStream : public Core::Reader::Stream {
+ public:
+  static constexpr Count default_window = 1 << 16;
+
+  FileStream(Core::View::Bytes location, Count window_size = default_window);
+  FileStream(const FileStream&) = delete;
+  ~FileStream();
+
+  auto fetch(Count offset, Count minimum) -> Core::View::Bytes override;
+  auto get_size() const -> Count override { return size; }
+  constexpr auto is_valid() const -> Bool { return handle >= 0; }
+
+ private:
+  Memory::Dynamic::Bytes buffer;
+  Count buffer_offset = 0;
+  Count buffer_fill = 0;
+  Count size = 0;
+  Signed_32 handle = -1;
+};
+
+// Streams a file on disk by mapping a page aligned window of it at a time,
+// sliding the mapping forward as it's read. Unlike FileStream a fetch is never
+// cut short by the window size, the mapping grows to fit the request instead.
+class MappedStream : public Core::Reader::Stream {
+ public:
+  static constexpr Count default_window = 1 << 20;
+
+  MappedStream(Core::View::Bytes location, Count window_size = default_window);
+  MappedStream(const MappedStream&) = delete;
+  ~MappedStream();
+
+  auto fetch(Count offset, Count minimum) -> Core::View::Bytes override;
+  auto get_size() const -> Count override { return size; }
+  constexpr auto is_valid() const -> Bool { return handle >= 0; }
+
+ private:
+  auto unmap() -> void;
+
+  Bits_8* mapping = nullptr;
+  Count mapping_offset = 0;
+  Count mapping_size = 0;
+  Count window_size = 0;
+  Count size = 0;
+  Signed_32 handle = -1;
+};
+#endif
+
 }  // namespace Perimortem::System
@@ -6,10 +6,12 @@
 namespace Perimortem::Utility {
 
 // A simple tuple used for representing an association between key and value.
+//
+// Empty value types take no space so a pair can be used as a lone key.
 template <typename key_type, typename value_type>
 struct Pair {
   key_type key;
-  value_type value;
+  [[no_unique_address]] value_type value;
 };
 
 }  // namespace Perimortem::Utility
@@ -48,6 +48,11 @@ struct SampleStats {
   Bits_64 alloc_requests_per_iter;
 };
 
+struct Report {
+  View::Bytes label;
+  Real_64 value;
+};
+
 static constexpr Count max_benchmark_count = 1024;
 static constexpr Count max_sample_count = 4096;
 static constexpr Real_64 time_cap_seconds = 1.5;
@@ -55,6 +60,9 @@ static constexpr Real_64 time_cap_seconds = 1.5;
 static Static::Vector<Instance, max_benchmark_count> binary_benchmarks;
 static Static::Vector<Bits_64, max_sample_count> time_samples;
 static Count benchmark_count = 0;
+static constexpr Count max_report_count = 4;
+static Static::Vector<Report, max_report_count> reports;
+static Count report_count = 0;
 static View::Bytes bench_filter = {};
 
 #ifdef PERI_BENCH_CPP
@@ -167,6 +175,13 @@ auto print_stats(View::Bytes name, Count col_width, const SampleStats& stats)
         (long long)stats.alloc_requests_per_iter, clear_color);
   }
 
+  for (Count index = 0; index < report_count; index++) {
+    const auto& report = reports[index];
+    printf(
+        "  | %s%.*s %.3f%s", system_color, (int)report.label.get_size(),
+        Data::cast<char>(report.label.get_data()), report.value, clear_color);
+  }
+
   printf("\n");
 }
 
@@ -190,8 +205,23 @@ auto Benchmark::end_time() -> void {
   sample_end = Time::now();
 }
 
+auto Benchmark::report(View::Bytes label, Real_64 value) -> void {
+  for (Count index = 0; index < report_count; index++) {
+    if (reports[index].label == label) {
+      reports[index].value = value;
+      return;
+    }
+  }
+
+  if (report_count < max_report_count) {
+    reports[report_count++] = {label, value};
+  }
+}
+
 auto run_samples(const Harness& harness, Benchmark::BenchmarkFunc func)
     -> SampleStats {
+  report_count = 0;
+
   // Perform one run as a warm up.
   harness.setup();
   func();
@@ -20,6 +20,11 @@ auto start_time() -> void;
 // Lets the test override the end timestamp.
 auto end_time() -> void;
 
+// Attach a measurement other than time to the running benchmark, such as a
+// table's probe distance. Reports are printed after the timings and a label
+// reported again by a later sample replaces the earlier value.
+auto report(Perimortem::Core::View::Bytes label, Real_64 value) -> void;
+
 auto create(
     const Harness& harness,
     Perimortem::Core::View::Bytes name,
@@ -7,6 +7,7 @@
 
 #include "perimortem/core/access/bytes.hpp"
 #include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/static/vector.hpp"
 #include "perimortem/core/data.hpp"
 #include "perimortem/core/null_terminated.hpp"
 #include "perimortem/core/perimortem.hpp"
@@ -55,6 +56,26 @@ PERIMORTEM_BENCHMARK(BinaryBench, binary_read_64) {
   Benchmark::prevent_optimization(accumulator);
 }
 
+static Static::Vector<Bits_32, (1 << 12) / sizeof(Bits_32)> table;
+
+PERIMORTEM_BENCHMARK(BinaryBench, binary_read_32_big) {
+  Reader::Binary<Data::ByteOrder::Big> reader(io_buffer.get_view());
+  for (Count i = 0; i < table.get_size(); i++) {
+    table.get_data()[i] = reader.read_bits_32();
+  }
+
+  Bits_32 last = table[table.get_size() - 1];
+  Benchmark::prevent_optimization(last);
+}
+
+PERIMORTEM_BENCHMARK(BinaryBench, binary_read_array_32_big) {
+  Reader::Binary<Data::ByteOrder::Big> reader(io_buffer.get_view());
+  reader.read_array(table.get_access());
+
+  Bits_32 last = table[table.get_size() - 1];
+  Benchmark::prevent_optimization(last);
+}
+
 PERIMORTEM_BENCHMARK(BinaryBench, binary_read_view) {
   Reader::Binary<Data::ByteOrder::Little> reader(io_buffer.get_view());
   Count accumulator = 0;
@@ -89,6 +110,14 @@ PERIMORTEM_BENCHMARK(BinaryBench, binary_write_64) {
   Benchmark::prevent_optimization(loc);
 }
 
+PERIMORTEM_BENCHMARK(BinaryBench, binary_write_array_32_big) {
+  Writer::Binary<Data::ByteOrder::Big> writer(io_buffer.get_access());
+  writer << table.get_view();
+
+  Count loc = writer.get_location();
+  Benchmark::prevent_optimization(loc);
+}
+
 PERIMORTEM_BENCHMARK(BinaryBench, binary_write_view) {
   Writer::Binary<Data::ByteOrder::Little> writer(io_buffer.get_access());
 
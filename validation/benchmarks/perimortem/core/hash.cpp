@@ -13,6 +13,7 @@
 #include "perimortem/core/hash.hpp"
 #include "perimortem/core/null_terminated.hpp"
 #include "perimortem/core/perimortem.hpp"
+#include "perimortem/core/time.hpp"
 
 #include "perimortem/system/random.hpp"
 
@@ -97,6 +98,97 @@ HASH_BENCH(4096);
 HASH_BENCH(8192);
 #endif
 
+// Content hashing of whole assets where the bulk path should keep up with
+// memory bandwidth. The stream variants feed the same bytes in reads like an
+// archive loader would, with the odd read size forcing partial stripes.
+static constexpr Count content_size = 1 << 22;
+static Static::Bytes<content_size> content_buffer;
+
+static Harness ContentHashBench = {
+  .name = "Content Hashing"_view,
+  .init = []() { fill_hash(content_buffer); },
+};
+
+template <Count size>
+auto content_hash() -> void {
+  Bits_64 result = Hash(content_buffer.get_view().slice(0, size)).get_value();
+  Benchmark::prevent_optimization(result);
+}
+
+template <Count size, Count read_size>
+auto content_stream() -> void {
+  Hash::Stream stream;
+  for (Count offset = 0; offset < size; offset += read_size) {
+    stream.update(content_buffer.get_view().slice(offset, read_size));
+  }
+  Bits_64 result = stream.finish();
+  Benchmark::prevent_optimization(result);
+}
+
+PERIMORTEM_BENCHMARK(ContentHashBench, one_shot_64kb) {
+  content_hash<1 << 16>();
+}
+
+PERIMORTEM_BENCHMARK(ContentHashBench, one_shot_4mb) {
+  content_hash<content_size>();
+}
+
+PERIMORTEM_BENCHMARK(ContentHashBench, stream_4mb_64kb_reads) {
+  content_stream<content_size, 1 << 16>();
+}
+
+PERIMORTEM_BENCHMARK(ContentHashBench, stream_4mb_1000b_reads) {
+  content_stream<content_size, 1000>();
+}
+
+// Throughput against key size, so the hand off points between the short, block
+// and bulk paths show up as steps in the curve. Every run hashes the same
+// number of bytes, split into keys of the given size.
+static constexpr Count throughput_bytes = 1 << 20;
+
+static Harness HashThroughputBench = {
+  .name = "Hash Throughput"_view,
+  .init = []() { fill_hash(content_buffer); },
+};
+
+template <Count key_size>
+auto hash_throughput() -> void {
+  constexpr Count key_count = Math::max(throughput_bytes / key_size, Count(1));
+  const auto data = content_buffer.get_view();
+
+  const Time start = Time::now();
+  Bits_64 accumulator = 0;
+  for (Count i = 0; i < key_count; i++) {
+    // Chaining the offset on the last hash keeps the calls from overlapping,
+    // which real lookups can't do either.
+    const Count offset = i * key_size + (accumulator & 7);
+    accumulator ^= Hash(data.slice(offset, key_size)).get_value();
+  }
+  const Real_64 seconds = start.measure().convert_to_seconds();
+  Benchmark::prevent_optimization(accumulator);
+
+  const Real_64 bytes = Real_64(key_count * key_size);
+  Benchmark::report("GB/s"_view, bytes / seconds / 1'000'000'000.0);
+}
+
+#define THROUGHPUT_BENCH(key_size)                                  \
+  PERIMORTEM_BENCHMARK(HashThroughputBench, key_size_##key_size) { \
+    hash_throughput<key_size>();                                    \
+  }
+
+THROUGHPUT_BENCH(4);
+THROUGHPUT_BENCH(8);
+THROUGHPUT_BENCH(16);
+THROUGHPUT_BENCH(24);
+THROUGHPUT_BENCH(32);
+THROUGHPUT_BENCH(64);
+THROUGHPUT_BENCH(256);
+THROUGHPUT_BENCH(1000);
+THROUGHPUT_BENCH(1024);
+THROUGHPUT_BENCH(4096);
+THROUGHPUT_BENCH(65536);
+THROUGHPUT_BENCH(1048576);
+
 #ifdef PERI_BENCH_CPP
 
 template <Count hash_length>
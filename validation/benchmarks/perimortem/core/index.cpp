@@ -0,0 +1,182 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#ifdef PERI_BENCH_CPP
+#include <algorithm>
+#define PERI_SLOW_BENCH
+#endif
+
+#include "perimortem/core/algorithm/index.hpp"
+
+#include "validation/benchmark.hpp"
+
+#include "perimortem/core/view/vector.hpp"
+#include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/algorithm/sort.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/perimortem.hpp"
+
+#include "perimortem/memory/dynamic/vector.hpp"
+
+#include "perimortem/system/random.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+using namespace Perimortem::System;
+using namespace Validation;
+
+// Every sample resolves a full set of queries so the reported time is the cost
+// of a single lookup.
+static constexpr Count query_count = 4096;
+static Static::Vector<Bits_64, query_count> queries;
+static Static::Vector<Count, query_count> results;
+
+// Branchless lower bound used as the baseline the index has to beat.
+auto binary_lower_bound(View::Vector<Bits_64> sorted, Bits_64 value) -> Count {
+  if (sorted.is_empty()) {
+    return 0;
+  }
+
+  const Bits_64* base = sorted.get_data();
+  Count length = sorted.get_size();
+  while (length > 1) {
+    const Count half = length / 2;
+    base = (value > base[half - 1]) ? base + half : base;
+    length -= half;
+  }
+
+  return Count(base - sorted.get_data()) + ((value > *base) ? 1 : 0);
+}
+
+// Sorted keys and their index are built once per table size since building a
+// 100M key table takes far longer than the benchmark itself.
+template <Count key_count>
+struct IndexedKeys {
+  Dynamic::Vector<Bits_64> keys;
+  Algorithm::SearchIndex<Bits_64> index;
+
+  IndexedKeys() {
+    keys.resize(key_count);
+    for (Count i = 0; i < key_count; i++) {
+      keys[i] = Random::generate();
+    }
+
+    Algorithm::sort(keys.get_access());
+    index.build(keys.get_view());
+  }
+
+  static auto get() -> IndexedKeys& {
+    static IndexedKeys instance;
+    return instance;
+  }
+};
+
+// Half of the queries are keys in the table and half are random misses.
+template <Count key_count>
+auto populate_queries() -> void {
+  auto& table = IndexedKeys<key_count>::get();
+  for (Count i = 0; i < query_count; i++) {
+    const Bits_64 random = Random::generate();
+    queries[i] = (random & 1) ? table.keys[random % key_count] : random;
+  }
+}
+
+template <Count key_count>
+auto binary_test() -> void {
+  auto& table = IndexedKeys<key_count>::get();
+  Count accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < query_count; i++) {
+    accumulator += binary_lower_bound(table.keys.get_view(), queries[i]);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+}
+
+template <Count key_count>
+auto index_test() -> void {
+  auto& table = IndexedKeys<key_count>::get();
+  Count accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < query_count; i++) {
+    accumulator += table.index.lower_bound(queries[i]);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+}
+
+template <Count key_count>
+auto batched_test() -> void {
+  auto& table = IndexedKeys<key_count>::get();
+
+  Benchmark::start_time();
+  table.index.lower_bound(queries.get_view(), results.get_access());
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(results[0]);
+}
+
+#define INDEX_TEST_RANGE(count)                                           \
+  static Harness IndexKeys_##count = {                                    \
+    .name = "Search Index " #count " keys"_view,                          \
+    .setup = populate_queries<count>,                                     \
+    .batch_count = query_count,                                           \
+  };                                                                      \
+  PERIMORTEM_BENCHMARK(IndexKeys_##count, count##_binary) {               \
+    binary_test<count>();                                                 \
+  }                                                                       \
+  PERIMORTEM_BENCHMARK(IndexKeys_##count, count##_index) {                \
+    index_test<count>();                                                  \
+  }                                                                       \
+  PERIMORTEM_BENCHMARK(IndexKeys_##count, count##_batched) {              \
+    batched_test<count>();                                                \
+  }
+
+INDEX_TEST_RANGE(1000);
+INDEX_TEST_RANGE(100000);
+#ifdef PERI_SLOW_BENCH
+INDEX_TEST_RANGE(1000000);
+INDEX_TEST_RANGE(10000000);
+INDEX_TEST_RANGE(100000000);
+#endif
+
+#ifdef PERI_BENCH_CPP
+
+template <Count key_count>
+auto cpp_lower_bound_test() -> void {
+  auto& table = IndexedKeys<key_count>::get();
+  const Bits_64* begin = table.keys.get_data();
+  const Bits_64* end = begin + key_count;
+  Count accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < query_count; i++) {
+    accumulator += Count(std::lower_bound(begin, end, queries[i]) - begin);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+}
+
+#define INDEX_COMPARISON(count)                             \
+  static Benchmark::Comparison index_##count##_comp = {     \
+    .harness = &IndexKeys_##count,                          \
+    .label = #count " keys"_view,                           \
+    .variants =                                             \
+        {                                                   \
+          {"binary"_view, #count "_binary"_view},           \
+          {"index"_view, #count "_index"_view},             \
+          {"batched"_view, #count "_batched"_view},         \
+        },                                                  \
+  };                                                        \
+  PERIMORTEM_COMPARISON(index_##count##_comp) {             \
+    cpp_lower_bound_test<count>();                          \
+  }
+
+INDEX_COMPARISON(1000)
+INDEX_COMPARISON(100000)
+INDEX_COMPARISON(1000000)
+INDEX_COMPARISON(10000000)
+INDEX_COMPARISON(100000000)
+
+#endif  // PERI_BENCH_CPP
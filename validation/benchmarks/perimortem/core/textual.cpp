@@ -3,7 +3,9 @@
 
 #ifdef PERI_BENCH_CPP
 #include <charconv>
+#include <cstdlib>
 #include <cstring>
+#include <string>
 #include <string_view>
 #endif
 
@@ -134,3 +136,220 @@ PERIMORTEM_BENCHMARK(TextualReadBench, read_floats) {
   }
   Benchmark::prevent_optimization(accumulator);
 }
+
+PERIMORTEM_BENCHMARK(TextualReadBench, read_floats_exact) {
+  // Full precision values as written back out by Writer::Textual, so the
+  // 17 digit and exponent paths get exercised.
+  Static::Vector<View::Bytes, 16> values = {
+    {"0.30000000000000004"_view, "1.7976931348623157e308"_view,
+     "5e-324"_view, "2.2250738585072014e-308"_view, "6.02214076e23"_view,
+     "-1.602176634e-19"_view, "3.141592653589793"_view,
+     "2.718281828459045"_view, "1e23"_view, "9007199254740993"_view,
+     "-8.98846567431158e307"_view, "1.4142135623730951"_view,
+     "4.9406564584124654e-324"_view, "123456789.12345679"_view,
+     "-0.0001220703125"_view, "7.038531e-26"_view}};
+  Real_64 accumulator = 0.0;
+  for (Count i = 0; i < batch_count; i++) {
+    Reader::Textual reader(values[i & 0xF]);
+    accumulator += reader.read_real_64();
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+// The kind of payload data exports and RPC responses are full of.
+static constexpr auto int_array_text =
+    "[0,17,-4,1048576,99,-2147483648,2147483647,31337,12,-1,4096,65535,"
+    "1234567890123,7,-98765,5000000000000000000]"_view;
+static constexpr Signed_64 int_array_values[] = {
+  0, 17, -4, 1048576, 99, -2147483648LL, 2147483647, 31337, 12, -1, 4096,
+  65535, 1234567890123LL, 7, -98765, 5000000000000000000LL};
+
+PERIMORTEM_BENCHMARK(TextualReadBench, read_int_array) {
+  Signed_64 values[16];
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count / 16; i++) {
+    Reader::Textual reader(int_array_text.slice(1));
+    accumulator += reader.read_array(Access::Vector<Signed_64>(values));
+    accumulator += values[i & 0xF];
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+PERIMORTEM_BENCHMARK(TextualBench, write_int_array) {
+  Static::Bytes<256> buffer;
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count / 16; i++) {
+    Writer::Textual writer(buffer.get_access());
+    writer.write_array(View::Vector<Signed_64>(int_array_values), ","_view);
+    accumulator += writer.get_location();
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+PERIMORTEM_BENCHMARK(TextualBench, write_message_chained) {
+  Static::Bytes<256> buffer;
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    Writer::Textual writer(buffer.get_access());
+    writer << "Binary read over ran buffer at read location "_view << i
+           << ". source_size="_view << batch_count << ", read_size="_view
+           << (i & 0xF);
+    accumulator += writer.get_location();
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+PERIMORTEM_BENCHMARK(TextualBench, write_message_format) {
+  Static::Bytes<256> buffer;
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    Writer::Textual writer(buffer.get_access());
+    writer.format<
+        "Binary read over ran buffer at read location {}. source_size={}, "
+        "read_size={}">(i, Count(batch_count), i & 0xF);
+    accumulator += writer.get_location();
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+#ifdef PERI_BENCH_CPP
+
+static auto cpp_to_chars_floats() -> void {
+  static constexpr Real_64 values[] = {
+    1.0, -21.05, 781.012, 1200041.01, 2390.0037, 0.01234567, 890.098, 0.0,
+    -0.000123, 9999.9999, 3.14159265, -2718.28, 812.99149, 29184.124,
+    123456789.0, 0.123456789};
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    char buffer[24];
+    const auto result =
+        std::to_chars(buffer, buffer + sizeof(buffer), values[i & 0xF]);
+    accumulator += result.ptr - buffer;
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+// strtod needs null terminated input so these are plain literals.
+static auto cpp_strtod_floats() -> void {
+  static constexpr const char* values[] = {
+    "1.0",       "-21.05",    "781.012",    "1200041.01",
+    "2390.0037", "0.01234567", "890.098",   "0",
+    "-0.000123", "9999.9999", "3.14159265", "-2718.28",
+    "abc",       "1.2.3",     "xyz",        "number"};
+  Real_64 accumulator = 0.0;
+  for (Count i = 0; i < batch_count; i++) {
+    char* end;
+    const Real_64 real_value = std::strtod(values[i & 0xF], &end);
+    if (end != values[i & 0xF]) {
+      accumulator += real_value;
+    } else {
+      accumulator -= 1;
+    }
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+static auto cpp_strtod_floats_exact() -> void {
+  static constexpr const char* values[] = {
+    "0.30000000000000004",     "1.7976931348623157e308",
+    "5e-324",                  "2.2250738585072014e-308",
+    "6.02214076e23",           "-1.602176634e-19",
+    "3.141592653589793",       "2.718281828459045",
+    "1e23",                    "9007199254740993",
+    "-8.98846567431158e307",   "1.4142135623730951",
+    "4.9406564584124654e-324", "123456789.12345679",
+    "-0.0001220703125",        "7.038531e-26"};
+  Real_64 accumulator = 0.0;
+  for (Count i = 0; i < batch_count; i++) {
+    accumulator += std::strtod(values[i & 0xF], nullptr);
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+static auto cpp_strtoll_int_array() -> void {
+  static const std::string text(int_array_text.get_data() + 1,
+                                int_array_text.get_data() +
+                                    int_array_text.get_size());
+  Signed_64 values[16];
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count / 16; i++) {
+    const char* cursor = text.c_str();
+    Count count = 0;
+    while (count < 16) {
+      char* end;
+      values[count] = std::strtoll(cursor, &end, 10);
+      if (end == cursor) {
+        break;
+      }
+      count++;
+      cursor = *end == ',' ? end + 1 : end;
+    }
+    accumulator += count + values[i & 0xF];
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+static auto cpp_to_chars_int_array() -> void {
+  char buffer[256];
+  Count accumulator = 0;
+  for (Count i = 0; i < batch_count / 16; i++) {
+    char* cursor = buffer;
+    for (Count j = 0; j < 16; j++) {
+      if (j) {
+        *cursor++ = ',';
+      }
+      cursor =
+          std::to_chars(cursor, buffer + sizeof(buffer), int_array_values[j])
+              .ptr;
+    }
+    accumulator += cursor - buffer;
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+static Benchmark::Comparison write_floats_comp = {
+  .harness = &TextualBench,
+  .label = "write floats"_view,
+  .variants = {{"shortest"_view, "write_floats"_view}},
+};
+PERIMORTEM_COMPARISON(write_floats_comp) {
+  cpp_to_chars_floats();
+}
+
+static Benchmark::Comparison read_floats_comp = {
+  .harness = &TextualReadBench,
+  .label = "read floats"_view,
+  .variants = {{"eisel-lemire"_view, "read_floats"_view}},
+};
+PERIMORTEM_COMPARISON(read_floats_comp) {
+  cpp_strtod_floats();
+}
+
+static Benchmark::Comparison read_floats_exact_comp = {
+  .harness = &TextualReadBench,
+  .label = "read floats exact"_view,
+  .variants = {{"eisel-lemire"_view, "read_floats_exact"_view}},
+};
+PERIMORTEM_COMPARISON(read_floats_exact_comp) {
+  cpp_strtod_floats_exact();
+}
+
+static Benchmark::Comparison read_int_array_comp = {
+  .harness = &TextualReadBench,
+  .label = "read int array"_view,
+  .variants = {{"simd"_view, "read_int_array"_view}},
+};
+PERIMORTEM_COMPARISON(read_int_array_comp) {
+  cpp_strtoll_int_array();
+}
+
+static Benchmark::Comparison write_int_array_comp = {
+  .harness = &TextualBench,
+  .label = "write int array"_view,
+  .variants = {{"digit pairs"_view, "write_int_array"_view}},
+};
+PERIMORTEM_COMPARISON(write_int_array_comp) {
+  cpp_to_chars_int_array();
+}
+
+#endif  // PERI_BENCH_CPP
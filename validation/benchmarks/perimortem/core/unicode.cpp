@@ -0,0 +1,78 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/algorithm/unicode.hpp"
+
+#include "validation/benchmark.hpp"
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/perimortem.hpp"
+
+#include "perimortem/memory/dynamic/line_index.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+using namespace Validation;
+static constexpr Count batch_count = 1024;
+
+static constexpr Static::Bytes ascii_source =
+    "func build_pipeline(pass: RenderPass) -> Pipeline {\n"
+    "  if pass.width == 0 { return error(\"zero width\") }\n"
+    "  while pending_jobs > 0 {\n"
+    "    entity job = queue.next()\n"
+    "    job.execute()\n"
+    "  }\n"
+    "  return pipeline.build(pass)\n"
+    "}\n"_bytes;
+
+// Comments and strings in other languages mixed in with the code.
+static constexpr Static::Bytes mixed_source =
+    "// Caf\xC3\xA9 r\xC3\xA9sum\xC3\xA9 na\xC3\xAFve \xE2\x82\xAC 100\n"
+    "func greet() -> Text {\n"
+    "  return \"\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF\"\n"
+    "}\n"
+    "// \xF0\x9F\x9A\x80 \xF0\x9F\x94\xA5 \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2"
+    "\xD0\xB5\xD1\x82\n"
+    "func main() -> Signed_32 { return greet().size }\n"_bytes;
+
+static Harness AlgorithmUnicode = {
+  .name = "Unicode"_view,
+  .batch_count = batch_count,
+};
+
+PERIMORTEM_BENCHMARK(AlgorithmUnicode, validate_ascii) {
+  Count result = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    result += Algorithm::validate_utf8(ascii_source.get_view()) ? 1 : 0;
+  }
+  Benchmark::prevent_optimization(result);
+}
+
+PERIMORTEM_BENCHMARK(AlgorithmUnicode, validate_mixed) {
+  Count result = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    result += Algorithm::validate_utf8(mixed_source.get_view()) ? 1 : 0;
+  }
+  Benchmark::prevent_optimization(result);
+}
+
+PERIMORTEM_BENCHMARK(AlgorithmUnicode, utf16_length_mixed) {
+  Count result = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    result += Algorithm::utf16_length(mixed_source.get_view());
+  }
+  Benchmark::prevent_optimization(result);
+}
+
+PERIMORTEM_BENCHMARK(AlgorithmUnicode, line_index_lookup) {
+  static Dynamic::LineIndex index(mixed_source.get_view());
+
+  Count result = 0;
+  for (Count i = 0; i < batch_count; i++) {
+    const auto position = index.get_position(i % mixed_source.get_size());
+    result += index.get_offset(position);
+  }
+  Benchmark::prevent_optimization(result);
+}
@@ -0,0 +1,99 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/benchmark.hpp"
+
+#include "perimortem/core/thread/worker.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/perimortem.hpp"
+
+#include "perimortem/memory/concurrent/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+using namespace Validation;
+
+// Every key the benchmark touches is inserted up front from the main thread so
+// workers never grow a shard. Writes only overwrite, erase or reinsert keys
+// from the same universe.
+static constexpr Count key_count = 1 << 16;
+static constexpr Count ops_per_thread = 1 << 16;
+static Concurrent::Map<Signed_32, Signed_32> shared_map;
+static Count next_lane = 0;
+
+auto populate_shared_map() -> void {
+  shared_map.ensure_capacity(key_count);
+  for (Count i = 0; i < key_count; i++) {
+    shared_map.insert(Signed_32(i), Signed_32(i));
+  }
+}
+
+auto reset_lanes() -> void {
+  next_lane = 0;
+}
+
+static Harness ConcurrentMapMix = {
+  .name = "Concurrent Map Read/Write Mix"_view,
+  .init = populate_shared_map,
+  .setup = reset_lanes,
+};
+
+// Each worker runs its own xorshift so threads don't fight over a shared
+// random state.
+template <Count read_percent>
+auto mixed_job() -> void {
+  Bits_64 state = (__atomic_fetch_add(&next_lane, 1, __ATOMIC_RELAXED) + 1) *
+                  0x9E3779B97F4A7C15ull;
+  Signed_32 accumulator = 0;
+
+  for (Count i = 0; i < ops_per_thread; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    const auto key = Signed_32(state % key_count);
+    if ((state >> 32) % 100 < read_percent) {
+      accumulator += shared_map.find_or_default(key, 0);
+    } else if ((state >> 40) & 1) {
+      shared_map.insert(key, key);
+    } else if (shared_map.erase(key)) {
+      shared_map.insert(key, key);
+    }
+  }
+
+  Benchmark::prevent_optimization(accumulator);
+}
+
+template <Count thread_count, Count read_percent>
+auto mixed_test() -> void {
+  static_assert(thread_count <= Thread::Worker::max_workers());
+  Thread::Worker workers[thread_count];
+
+  Benchmark::start_time();
+  for (Count i = 0; i < thread_count; i++) {
+    workers[i] =
+        Thread::Worker::start("map_bench"_view, mixed_job<read_percent>);
+  }
+  for (Count i = 0; i < thread_count; i++) {
+    workers[i].join();
+  }
+  Benchmark::end_time();
+}
+
+#define CONCURRENT_MAP_TEST(threads, reads)                        \
+  PERIMORTEM_BENCHMARK(                                            \
+      ConcurrentMapMix, threads##_threads_##reads##_reads) {       \
+    mixed_test<threads, reads>();                                  \
+  }
+
+#define CONCURRENT_MAP_TEST_RANGE(threads) \
+  CONCURRENT_MAP_TEST(threads, 100)        \
+  CONCURRENT_MAP_TEST(threads, 95)         \
+  CONCURRENT_MAP_TEST(threads, 50)
+
+CONCURRENT_MAP_TEST_RANGE(1)
+CONCURRENT_MAP_TEST_RANGE(2)
+CONCURRENT_MAP_TEST_RANGE(4)
+CONCURRENT_MAP_TEST_RANGE(8)
+CONCURRENT_MAP_TEST_RANGE(16)
+CONCURRENT_MAP_TEST_RANGE(32)
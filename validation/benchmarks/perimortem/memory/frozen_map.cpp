@@ -0,0 +1,131 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/benchmark.hpp"
+
+#include "perimortem/core/view/bytes.hpp"
+#include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/perimortem.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+#include "perimortem/memory/frozen/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+using namespace Validation;
+
+// Asset path style keys, `assets/` followed by 8 hex digits.
+static constexpr Count max_key_count = 1 << 16;
+static constexpr Count key_length = 15;
+static Bits_8 key_text[max_key_count * key_length];
+static Static::Vector<View::Bytes, max_key_count> keys;
+
+auto populate_keys() -> void {
+  constexpr Bits_8 hex[] = "0123456789abcdef";
+  for (Count i = 0; i < max_key_count; i++) {
+    Bits_8* key = key_text + i * key_length;
+    Data::copy(key, "assets/", 7);
+    for (Count digit = 0; digit < 8; digit++) {
+      key[7 + digit] = hex[((i * 2654435761) >> (digit * 4)) & 0xF];
+    }
+    keys[i] = View::Bytes(key, key_length);
+  }
+}
+
+static Harness FrozenMapStartup = {
+  .name = "Frozen Map Startup"_view,
+  .init = populate_keys,
+};
+
+using SourceMap = Dynamic::Map<Dynamic::Bytes, Count>;
+using FrozenMap = Frozen::Map<View::Bytes, Count>;
+
+// The table every process start would otherwise rebuild.
+template <Count key_count>
+struct Tables {
+  SourceMap source;
+  Dynamic::Bytes image;
+
+  Tables() {
+    for (Count i = 0; i < key_count; i++) {
+      source.insert(keys[i], i);
+    }
+    FrozenMap::freeze(source, image);
+  }
+
+  static auto get() -> Tables& {
+    static Tables instance;
+    return instance;
+  }
+};
+
+template <Count key_count>
+auto rebuild_test() -> void {
+  Benchmark::start_time();
+  SourceMap local_map(key_count);
+  for (Count i = 0; i < key_count; i++) {
+    local_map.insert(keys[i], i);
+  }
+  Benchmark::end_time();
+
+  Count size = local_map.get_size();
+  Benchmark::prevent_optimization(size);
+}
+
+template <Count key_count>
+auto open_test() -> void {
+  auto& tables = Tables<key_count>::get();
+
+  Benchmark::start_time();
+  FrozenMap frozen(tables.image.get_view());
+  Benchmark::end_time();
+
+  Count size = frozen.get_size();
+  Benchmark::prevent_optimization(size);
+}
+
+template <Count key_count>
+auto dynamic_lookup_test() -> void {
+  auto& tables = Tables<key_count>::get();
+  Count accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < key_count; i++) {
+    accumulator += tables.source.find_or_default(keys[i], 0);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+}
+
+template <Count key_count>
+auto frozen_lookup_test() -> void {
+  auto& tables = Tables<key_count>::get();
+  FrozenMap frozen(tables.image.get_view());
+  Count accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < key_count; i++) {
+    accumulator += frozen.find_or_default(keys[i], 0);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+}
+
+#define FROZEN_MAP_TEST_RANGE(count)                                   \
+  PERIMORTEM_BENCHMARK(FrozenMapStartup, count##_rebuild) {            \
+    rebuild_test<count>();                                             \
+  }                                                                    \
+  PERIMORTEM_BENCHMARK(FrozenMapStartup, count##_open) {               \
+    open_test<count>();                                                \
+  }                                                                    \
+  PERIMORTEM_BENCHMARK(FrozenMapStartup, count##_dynamic_lookup) {     \
+    dynamic_lookup_test<count>();                                      \
+  }                                                                    \
+  PERIMORTEM_BENCHMARK(FrozenMapStartup, count##_frozen_lookup) {      \
+    frozen_lookup_test<count>();                                       \
+  }
+
+FROZEN_MAP_TEST_RANGE(1024)
+FROZEN_MAP_TEST_RANGE(65536)
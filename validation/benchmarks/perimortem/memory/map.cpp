@@ -32,6 +32,7 @@ using namespace Validation;
 constexpr auto scalar = Dynamic::MapVectorization::Scalar;
 constexpr auto partial = Dynamic::MapVectorization::Partial;
 constexpr auto full = Dynamic::MapVectorization::Full;
+constexpr auto wide = Dynamic::MapVectorization::Wide;
 
 constexpr Count max_key_count = 1 << 16;
 static Static::Vector<Signed_32, max_key_count> lookup_keys;
@@ -81,7 +82,8 @@ auto map_test() -> void {
 #define MAP_INT_TEST_RANGE(count, lookup) \
   MAP_INT_TEST(scalar, count, lookup);    \
   MAP_INT_TEST(partial, count, lookup);   \
-  MAP_INT_TEST(full, count, lookup);
+  MAP_INT_TEST(full, count, lookup);      \
+  MAP_INT_TEST(wide, count, lookup);
 
 constexpr auto lookup = True;
 constexpr auto insert = False;
@@ -102,6 +104,61 @@ MAP_INT_TEST_RANGE(16384, insert);
 MAP_INT_TEST_RANGE(65536, insert);
 #endif
 
+// Symbol resolution style lookups where half of the queries miss.
+static Static::Vector<Signed_32, max_key_count> batch_queries;
+static Static::Vector<Bool, max_key_count> batch_results;
+
+template <Dynamic::MapVectorization vector, Count values, Bool batched>
+auto map_batch_test() -> void {
+  Dynamic::Map<Signed_32, Signed_32, vector> local_map(values);
+  for (Count i = 0; i < values; i++) {
+    local_map.insert(lookup_keys[i], Signed_32(i));
+    batch_queries[i] = Signed_32(i * 2);
+  }
+  Count accumulator = 0;
+
+  auto queries = batch_queries.get_view().slice(0, values);
+  auto results = batch_results.get_access().slice(0, values);
+  Benchmark::start_time();
+  if constexpr (batched) {
+    local_map.contains_batch(queries, results);
+  } else {
+    for (Count i = 0; i < values; i++) {
+      results[i] = local_map.contains(queries[i]);
+    }
+  }
+  Benchmark::end_time();
+
+  for (Count i = 0; i < values; i++) {
+    accumulator += results[i] ? 1 : 0;
+  }
+  Benchmark::prevent_optimization(accumulator);
+}
+
+#define MAP_BATCH_TEST(type, count, var)                             \
+  PERIMORTEM_BENCHMARK(MapSigned_32s, var##_##count##_ints_##type) { \
+    map_batch_test<type, count, var>();                              \
+  }
+
+#define MAP_BATCH_TEST_RANGE(count)         \
+  MAP_BATCH_TEST(scalar, count, contains);  \
+  MAP_BATCH_TEST(partial, count, contains); \
+  MAP_BATCH_TEST(full, count, contains);    \
+  MAP_BATCH_TEST(wide, count, contains);    \
+  MAP_BATCH_TEST(scalar, count, batched);   \
+  MAP_BATCH_TEST(partial, count, batched);  \
+  MAP_BATCH_TEST(full, count, batched);     \
+  MAP_BATCH_TEST(wide, count, batched);
+
+constexpr auto contains = False;
+constexpr auto batched = True;
+
+MAP_BATCH_TEST_RANGE(1024);
+#ifdef PERI_SLOW_BENCH
+MAP_BATCH_TEST_RANGE(16384);
+MAP_BATCH_TEST_RANGE(65536);
+#endif
+
 static constexpr Pair<View::Bytes, Count> keyword_source[] = {
   {"as"_view, 0},         {"if"_view, 1},          {"for"_view, 2},
   {"new"_view, 3},        {"else"_view, 4},        {"func"_view, 5},
@@ -201,6 +258,7 @@ static Harness MapKeywords = {
   MAP_KEYWORD_TEST(scalar, count, mask);    \
   MAP_KEYWORD_TEST(partial, count, mask);   \
   MAP_KEYWORD_TEST(full, count, mask);      \
+  MAP_KEYWORD_TEST(wide, count, mask);      \
   MAP_TABLE_TEST(count, mask);
 #else
 #define MAP_KEYWORD_TEST_RANGE(count, mask) \
@@ -246,6 +304,120 @@ MAP_KEYWORD_TEST_RANGE(65536, hit_0004);
 MAP_KEYWORD_TEST_RANGE(65536, hit_0001);
 #endif
 
+// Integer lookups at a fixed hit rate where misses are keys past the end of
+// the table. Unlike the keyword tests the table grows with the lookup count so
+// this shows how each bucket width scales once the table leaves the cache.
+template <Dynamic::MapVectorization vector, Count values, Count mask>
+auto map_hit_rate_test() -> void {
+  Dynamic::Map<Signed_32, Signed_32, vector> local_map(values);
+  for (Count i = 0; i < values; i++) {
+    local_map.insert(lookup_keys[i], Signed_32(i));
+  }
+
+  for (Count i = 0; i < values; i++) {
+    auto index = Random::generate();
+    batch_queries[i] = (index & mask) ? Signed_32(values + (index % values))
+                                      : lookup_keys[index % values];
+  }
+  Signed_32 accumulator = 0;
+
+  Benchmark::start_time();
+  for (Count i = 0; i < values; i++) {
+    accumulator += local_map.find_or_default(batch_queries[i], -1);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+
+  const auto stats = local_map.get_statistics();
+  Benchmark::report("avg probe"_view, stats.average_probe_distance());
+  Benchmark::report("max probe"_view, Real_64(stats.max_probe_distance));
+}
+
+static Harness MapHitRates = {
+  .name = "Map Hit Rates"_view,
+  .init = populate_lookup_keys,
+};
+
+#define MAP_HIT_RATE_TEST(type, count, mask)                    \
+  PERIMORTEM_BENCHMARK(MapHitRates, count##_##mask##_##type) { \
+    map_hit_rate_test<type, count, mask>();                    \
+  }
+
+#define MAP_HIT_RATE_TEST_RANGE(count, mask) \
+  MAP_HIT_RATE_TEST(scalar, count, mask);    \
+  MAP_HIT_RATE_TEST(partial, count, mask);   \
+  MAP_HIT_RATE_TEST(full, count, mask);      \
+  MAP_HIT_RATE_TEST(wide, count, mask);
+
+MAP_HIT_RATE_TEST_RANGE(1024, hit_1000);
+MAP_HIT_RATE_TEST_RANGE(1024, hit_0001);
+#ifdef PERI_SLOW_BENCH
+MAP_HIT_RATE_TEST_RANGE(1024, hit_0500);
+MAP_HIT_RATE_TEST_RANGE(1024, hit_0062);
+MAP_HIT_RATE_TEST_RANGE(16384, hit_1000);
+MAP_HIT_RATE_TEST_RANGE(16384, hit_0500);
+MAP_HIT_RATE_TEST_RANGE(16384, hit_0062);
+MAP_HIT_RATE_TEST_RANGE(16384, hit_0001);
+MAP_HIT_RATE_TEST_RANGE(65536, hit_1000);
+MAP_HIT_RATE_TEST_RANGE(65536, hit_0500);
+MAP_HIT_RATE_TEST_RANGE(65536, hit_0062);
+MAP_HIT_RATE_TEST_RANGE(65536, hit_0001);
+#endif
+
+// Instrumented tables grown from empty with half of the lookups missing, so
+// the tag false positive rate and growth events are reported next to the time.
+// The counters add a little to every probe so only compare these timings
+// against each other.
+template <Dynamic::MapVectorization vector, Count values>
+auto map_quality_test() -> void {
+  Dynamic::Map<
+      Signed_32,
+      Signed_32,
+      vector,
+      0,
+      Dynamic::MapStorage::Bibliotheca,
+      true>
+      local_map;
+  for (Count i = 0; i < values; i++) {
+    local_map.insert(lookup_keys[i], Signed_32(i));
+  }
+
+  Signed_32 accumulator = 0;
+  Benchmark::start_time();
+  for (Count i = 0; i < values; i++) {
+    accumulator += local_map.find_or_default(Signed_32(i * 2), -1);
+  }
+  Benchmark::end_time();
+  Benchmark::prevent_optimization(accumulator);
+
+  const auto stats = local_map.get_statistics();
+  Benchmark::report("tag fp"_view, stats.false_positive_rate());
+  Benchmark::report("growths"_view, Real_64(stats.growth_events));
+  Benchmark::report("avg probe"_view, stats.average_probe_distance());
+}
+
+static Harness MapQuality = {
+  .name = "Map Quality"_view,
+  .init = populate_lookup_keys,
+};
+
+#define MAP_QUALITY_TEST(type, count)                        \
+  PERIMORTEM_BENCHMARK(MapQuality, grown_##count##_##type) { \
+    map_quality_test<type, count>();                         \
+  }
+
+#define MAP_QUALITY_TEST_RANGE(count) \
+  MAP_QUALITY_TEST(scalar, count);    \
+  MAP_QUALITY_TEST(partial, count);   \
+  MAP_QUALITY_TEST(full, count);      \
+  MAP_QUALITY_TEST(wide, count);
+
+MAP_QUALITY_TEST_RANGE(1024);
+#ifdef PERI_SLOW_BENCH
+MAP_QUALITY_TEST_RANGE(16384);
+MAP_QUALITY_TEST_RANGE(65536);
+#endif
+
 #ifdef PERI_BENCH_CPP
 
 template <Count values, Bool is_lookup>
@@ -304,6 +476,7 @@ auto cpp_keyword_test() -> void {
           {"scalar"_view, #var "_" #count "_ints_scalar"_view},   \
           {"partial"_view, #var "_" #count "_ints_partial"_view}, \
           {"full"_view, #var "_" #count "_ints_full"_view},       \
+          {"wide"_view, #var "_" #count "_ints_wide"_view},       \
         },                                                        \
   };                                                              \
   PERIMORTEM_COMPARISON(int_map_##var##_##count) {                \
@@ -331,6 +504,7 @@ INT_MAP_COMPARISON(65536, insert)
           {"scalar"_view, #count "_" #mask "_scalar"_view},   \
           {"partial"_view, #count "_" #mask "_partial"_view}, \
           {"full"_view, #count "_" #mask "_full"_view},       \
+          {"wide"_view, #count "_" #mask "_wide"_view},       \
           {"table"_view, #count "_" #mask "_table"_view},     \
         },                                                    \
   };                                                          \
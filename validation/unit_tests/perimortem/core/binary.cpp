@@ -6,6 +6,8 @@
 #include "validation/unit_test.hpp"
 
 #include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/math.hpp"
 #include "perimortem/core/null_terminated.hpp"
 #include "perimortem/core/writer/binary.hpp"
 
@@ -168,6 +170,184 @@ PERIMORTEM_UNIT_TEST(CoreBinaryReader, multiple_readers) {
   EXPECT_EQ(readers[1].get_location(), Count(2));
 }
 
+// Hands out a copy of a few bytes at a time so reads have to cross windows.
+class WindowStream : public Reader::Stream {
+ public:
+  WindowStream(View::Bytes source) : source(source) {}
+
+  auto fetch(Count offset, Count) -> View::Bytes override {
+    const Count size = Math::min(window_size, source.get_size() - offset);
+    Data::copy(window, source.get_data() + offset, size);
+    fetches++;
+    return View::Bytes(window, size);
+  }
+
+  auto get_size() const -> Count override { return source.get_size(); }
+
+  static constexpr Count window_size = 8;
+  Bits_8 window[window_size];
+  View::Bytes source;
+  Count fetches = 0;
+};
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, stream_reads) {
+  using Reader = Reader::Binary<Data::ByteOrder::Little>;
+  WindowStream stream(
+      "\x0A\x00\x00\x00\x14\x00\x00\x00"
+      "\x1E\x00\x00\x00\x00\x00\x00\x00"
+      "\x28\x00Hello"_view);
+  Reader reader(stream);
+
+  EXPECT_EQ(reader.get_size(), Count(23));
+  EXPECT_EQ(reader.read_bits_16(), Bits_16(0x0A));
+  EXPECT_EQ(reader.read_bits_32(), Bits_32(0x14));
+  EXPECT_EQ(reader.read_bits_64(), Bits_64(0x1E));
+  EXPECT_EQ(reader.read_bits_16(), Bits_16(0x28));
+  EXPECT_TEXT(reader.read_bytes(5), "Hello"_view);
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+  EXPECT_EQ(stream.fetches, Count(3));
+
+  // Going back reads the earlier window in again.
+  reader.set_pointer(4);
+  EXPECT_EQ(reader.read_bits_32(), Bits_32(0x14));
+  EXPECT_EQ(stream.fetches, Count(4));
+}
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, stream_alignment) {
+  using Reader = Reader::Binary<Data::ByteOrder::Big>;
+  WindowStream stream("\x01\x00\x00\x00\x00\x00\x00\x02\x03"_view);
+  Reader reader(stream);
+
+  // Alignment is counted from the start of the stream rather than wherever
+  // the window happens to live in memory.
+  reader.set_pointer(1);
+  EXPECT_EQ(reader.read_bits_32(), Bits_32(0x02));
+  EXPECT_EQ(reader.get_location(), Count(8));
+  EXPECT_EQ(reader.read_bits_8(), Bits_8(0x03));
+  EXPECT(reader.is_valid());
+}
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, stream_overflow) {
+  using Reader = Reader::Binary<Data::ByteOrder::Little>;
+  WindowStream stream("0123456789"_view);
+  Reader reader(stream);
+  auto scope_attribution = Diagnostics::Log::set_attribution();
+
+  // Larger than the window can hold.
+  EXPECT_EQ(reader.read_bytes(9).get_size(), Count(8));
+  EXPECT_NOT(reader.is_valid());
+
+  // Past the end of the stream.
+  reader.reset();
+  reader.set_pointer(8);
+  EXPECT_EQ(reader.read_bits_64(), Bits_64(0));
+  EXPECT_NOT(reader.is_valid());
+
+  constexpr auto error_message =
+      "Binary read over ran buffer at read location 8. source_size=10, read_size=8"_view;
+  EXPECT(Test::error_contains(error_message));
+}
+
+// Writes arrays long enough to take the vectorized paths, then reads them back
+// both in bulk and one value at a time. Returns how many values didn't match.
+template <Data::ByteOrder endian>
+static auto array_mismatches() -> Count {
+  Static::Vector<Bits_16, 37> bits_16(
+      [](Count i) -> Bits_16 { return Bits_16(0x0102 * i); });
+  Static::Vector<Signed_32, 37> signed_32(
+      [](Count i) -> Signed_32 { return -0x01020304 * Signed_32(i); });
+  Static::Vector<Bits_64, 37> bits_64(
+      [](Count i) -> Bits_64 { return 0x0102030405060708 * i; });
+  Static::Vector<Real_64, 5> reals(
+      [](Count i) -> Real_64 { return 1.5 * Real_64(i); });
+
+  alignas(8) Static::Bytes<1024> buffer;
+  Writer::Binary<endian> writer(buffer);
+  writer << Bits_8(0xAB) << bits_16.get_view() << signed_32.get_view()
+         << bits_64.get_view() << reals.get_view();
+
+  Static::Vector<Bits_16, 37> read_16;
+  Static::Vector<Signed_32, 37> read_32;
+  Static::Vector<Bits_64, 37> read_64;
+  Static::Vector<Real_64, 5> read_reals;
+  Reader::Binary<endian> reader(buffer);
+  Count mismatches = reader.read_bits_8() != 0xAB;
+  mismatches += reader.read_array(read_16.get_access()) ? 0 : 1;
+  mismatches += reader.read_array(read_32.get_access()) ? 0 : 1;
+  mismatches += reader.read_array(read_64.get_access()) ? 0 : 1;
+  mismatches += reader.read_array(read_reals.get_access()) ? 0 : 1;
+  mismatches += reader.get_location() != writer.get_location();
+
+  Reader::Binary<endian> scalar(buffer);
+  scalar.read_bits_8();
+  for (Count i = 0; i < 37; i++) {
+    mismatches += read_16[i] != bits_16[i];
+    mismatches += scalar.read_bits_16() != bits_16[i];
+  }
+  for (Count i = 0; i < 37; i++) {
+    mismatches += read_32[i] != signed_32[i];
+    mismatches += scalar.read_signed_bits_32() != signed_32[i];
+  }
+  for (Count i = 0; i < 37; i++) {
+    mismatches += read_64[i] != bits_64[i];
+    mismatches += scalar.read_bits_64() != bits_64[i];
+  }
+  for (Count i = 0; i < 5; i++) {
+    mismatches += read_reals[i] != reals[i];
+    mismatches += scalar.read_real_64() != reals[i];
+  }
+
+  return mismatches;
+}
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, read_array) {
+  EXPECT_EQ(array_mismatches<Data::ByteOrder::Little>(), Count(0));
+  EXPECT_EQ(array_mismatches<Data::ByteOrder::Big>(), Count(0));
+}
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, read_array_overflow) {
+  using Reader = Reader::Binary<Data::ByteOrder::Big>;
+  alignas(alignof(Bits_32)) Static::Bytes<12> source(
+      "\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03"_view);
+  Reader reader(source);
+  auto scope_attribution = Diagnostics::Log::set_attribution();
+
+  Static::Vector<Bits_32, 2> values;
+  EXPECT(reader.read_array(values.get_access()));
+  EXPECT_EQ(values[1], Bits_32(2));
+
+  // Only one left so nothing should be read.
+  EXPECT_NOT(reader.read_array(values.get_access()));
+  EXPECT_EQ(values[0], Bits_32(0));
+  EXPECT_EQ(values[1], Bits_32(0));
+  EXPECT_NOT(reader.is_valid());
+
+  constexpr auto error_message =
+      "Binary read over ran buffer at read location 8. source_size=12, read_size=8"_view;
+  EXPECT(Test::error_contains(error_message));
+}
+
+PERIMORTEM_UNIT_TEST(CoreBinaryReader, stream_read_array) {
+  using Reader = Reader::Binary<Data::ByteOrder::Big>;
+  WindowStream stream(
+      "\x07\x00\x00\x00"
+      "\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03"
+      "\x00\x00\x00\x04\x00\x00\x00\x05\x00\x00\x00\x06"_view);
+  Reader reader(stream);
+
+  // The array is three windows long and starts part way into the first.
+  Static::Vector<Bits_32, 6> values;
+  EXPECT_EQ(reader.read_bits_8(), Bits_8(0x07));
+  EXPECT(reader.read_array(values.get_access()));
+  for (Count i = 0; i < values.get_size(); i++) {
+    EXPECT_EQ(values[i], Bits_32(i + 1));
+  }
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+  EXPECT_EQ(stream.fetches, Count(4));
+}
+
 static Harness CoreBinaryWriter = {
   .name = "Core::Writer::Binary"_view,
 };
@@ -329,3 +509,28 @@ PERIMORTEM_UNIT_TEST(CoreBinaryWriter, multiple_writers) {
   EXPECT(writers[1].is_valid());
   EXPECT_HEX(buffer, "\xBB\xBB\xCC\xCC"_view);
 }
+
+PERIMORTEM_UNIT_TEST(CoreBinaryWriter, big_endian_arrays) {
+  using Writer = Writer::Binary<Data::ByteOrder::Big>;
+  alignas(8) Static::Bytes<24> buffer;
+  Writer writer(buffer);
+
+  Static::Vector<Bits_16, 2> bits{0x0102, 0x0304};
+  Static::Vector<Real_32, 1> reals{3.0f};
+  Static::Vector<Real_64, 1> doubles{1.5};
+  writer << bits.get_view() << reals.get_view() << doubles.get_view();
+
+  EXPECT(writer.is_valid());
+  EXPECT_EQ(writer.get_location(), Count(16));
+  EXPECT_HEX(
+      View::Bytes(buffer.get_data(), 16),
+      "\x01\x02\x03\x04"
+      "\x40\x40\x00\x00"
+      "\x3F\xF8\x00\x00\x00\x00\x00\x00"_view);
+
+  // Checked once for the whole array so nothing is written on overflow.
+  Static::Vector<Bits_64, 2> longs{1, 2};
+  writer << longs.get_view();
+  EXPECT_NOT(writer.is_valid());
+  EXPECT_HEX(View::Bytes(buffer.get_data() + 16, 8), "\0\0\0\0\0\0\0\0"_view);
+}
@@ -0,0 +1,106 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/hash.hpp"
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+using namespace Perimortem::Core;
+using namespace Validation;
+
+static Harness CoreHash = {
+  .name = "Core::Hash"_view,
+};
+
+// Large enough to cover the short path, the bulk threshold and a few rounds of
+// bulk stripes with a partial tail.
+static constexpr Count test_size = 5000;
+
+template <Count size>
+constexpr auto fill_pattern(Bits_8 (&data)[size]) -> void {
+  Bits_64 state = 0x9E3779B97F4A7C15;
+  for (Count i = 0; i < size; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    data[i] = Bits_8(state);
+  }
+}
+
+consteval auto constant_hash(Count size) -> Bits_64 {
+  Bits_8 data[test_size];
+  fill_pattern(data);
+  return Hash(View::Bytes(data, size)).get_value();
+}
+
+static Bits_8 pattern[test_size];
+
+PERIMORTEM_UNIT_TEST(CoreHash, constexpr_matches_runtime) {
+  fill_pattern(pattern);
+
+  // The scalar constexpr paths have to agree with the vectorized runtime ones.
+  constexpr Bits_64 short_hash = constant_hash(100);
+  constexpr Bits_64 threshold_hash = constant_hash(Hash::bulk_threshold);
+  constexpr Bits_64 bulk_hash = constant_hash(test_size);
+  EXPECT_EQ(Hash(View::Bytes(pattern, 100)).get_value(), short_hash);
+  EXPECT_EQ(
+      Hash(View::Bytes(pattern, Hash::bulk_threshold)).get_value(),
+      threshold_hash);
+  EXPECT_EQ(Hash(View::Bytes(pattern, test_size)).get_value(), bulk_hash);
+}
+
+PERIMORTEM_UNIT_TEST(CoreHash, bulk_sensitivity) {
+  fill_pattern(pattern);
+  const Bits_64 base = Hash(View::Bytes(pattern, test_size)).get_value();
+
+  // Flipping a bit in any stripe, including the overlapping tail, changes the
+  // hash.
+  const Count positions[] = {0, 63, 64, 1023, 1024, 2500, test_size - 1};
+  for (Count position : positions) {
+    pattern[position] ^= 0x10;
+    EXPECT(Hash(View::Bytes(pattern, test_size)).get_value() != base);
+    pattern[position] ^= 0x10;
+  }
+
+  // So does the length even when the extra bytes are zero.
+  Bits_8 zeros[2048] = {};
+  EXPECT(
+      Hash(View::Bytes(zeros, 2047)).get_value() !=
+      Hash(View::Bytes(zeros, 2048)).get_value());
+}
+
+PERIMORTEM_UNIT_TEST(CoreHash, stream_matches_one_shot) {
+  fill_pattern(pattern);
+
+  // Every size around the interesting boundaries, fed in uneven pieces.
+  const Count sizes[] = {0,    1,    7,    8,    15,   16,   17,   100,
+                         1023, 1024, 1025, 1087, 1088, 1089, 2048, 4999};
+  const Count piece_sizes[] = {1, 3, 64, 100, 1000, test_size};
+  for (Count size : sizes) {
+    const Bits_64 expected = Hash(View::Bytes(pattern, size)).get_value();
+    for (Count piece : piece_sizes) {
+      Hash::Stream stream;
+      for (Count offset = 0; offset < size; offset += piece) {
+        const Count length = Math::min(piece, size - offset);
+        stream.update(View::Bytes(pattern + offset, length));
+      }
+
+      ASSERT_EQ(stream.get_size(), size);
+      ASSERT_EQ(stream.finish(), expected);
+    }
+  }
+}
+
+PERIMORTEM_UNIT_TEST(CoreHash, stream_continues_after_finish) {
+  fill_pattern(pattern);
+
+  Hash::Stream stream;
+  stream.update(View::Bytes(pattern, 1500));
+  EXPECT_EQ(stream.finish(), Hash(View::Bytes(pattern, 1500)).get_value());
+
+  stream.update(View::Bytes(pattern + 1500, 1500));
+  EXPECT_EQ(stream.finish(), Hash(View::Bytes(pattern, 3000)).get_value());
+}
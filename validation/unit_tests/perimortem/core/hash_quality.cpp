@@ -0,0 +1,517 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+// SMHasher style quality checks for `Core::Hash`.
+//
+// The hash constants came out of benchmarking against real keys so these
+// tests are here to catch a retune that trades away distribution for speed.
+// Every check runs on deterministic keys and the limits leave room over the
+// current results for statistical noise, so a failure means the hash really
+// got worse rather than the test getting unlucky.
+
+#include "perimortem/core/hash.hpp"
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/access/vector.hpp"
+#include "perimortem/core/algorithm/sort.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/set.hpp"
+
+#include "perimortem/system/file.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+using namespace Perimortem::System;
+using namespace Validation;
+
+static Harness HashQuality = {
+  .name = "Core::Hash Quality"_view,
+};
+
+// Xorshift so every run probes the same keys.
+class KeySource {
+ public:
+  auto next() -> Bits_64 {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+
+  auto fill(Bits_8* data, Count size) -> void {
+    for (Count i = 0; i < size; i++) {
+      data[i] = Bits_8(next());
+    }
+  }
+
+ private:
+  Bits_64 state = 0x9E3779B97F4A7C15;
+};
+
+static constexpr Count max_key_size = 1100;
+static constexpr Count max_hash_count = 1 << 16;
+static Bits_8 key_buffer[max_key_size * 2];
+static Bits_64 hashes[max_hash_count];
+
+auto hash_bytes(const Bits_8* data, Count size) -> Bits_64 {
+  return Hash(View::Bytes(data, size)).get_value();
+}
+
+// Worst deviation from a 50% chance of an output bit flipping when a single
+// input bit flips (the strict avalanche criterion). Only every `bit_step`th
+// input bit is tested to keep long keys cheap.
+auto avalanche_bias(Count key_size, Count samples, Count bit_step) -> Real_64 {
+  KeySource source;
+  Real_64 worst = 0.0;
+  for (Count bit = 0; bit < key_size * 8; bit += bit_step) {
+    Count flips[64] = {};
+    for (Count sample = 0; sample < samples; sample++) {
+      source.fill(key_buffer, key_size);
+      const Bits_64 base = hash_bytes(key_buffer, key_size);
+      key_buffer[bit / 8] ^= Bits_8(1 << (bit % 8));
+      Bits_64 changed = base ^ hash_bytes(key_buffer, key_size);
+
+      while (changed) {
+        flips[__builtin_ctzg(changed)]++;
+        changed &= changed - 1;
+      }
+    }
+
+    for (Count out = 0; out < 64; out++) {
+      const Real_64 bias = Real_64(flips[out]) / Real_64(samples) - 0.5;
+      worst = Math::max(worst, bias < 0 ? -bias : bias);
+    }
+  }
+
+  return worst;
+}
+
+template <typename numeric_type>
+auto numeric_avalanche_bias(Count samples) -> Real_64 {
+  KeySource source;
+  Real_64 worst = 0.0;
+  for (Count bit = 0; bit < sizeof(numeric_type) * 8; bit++) {
+    Count flips[64] = {};
+    for (Count sample = 0; sample < samples; sample++) {
+      const auto key = numeric_type(source.next());
+      const auto flipped = numeric_type(key ^ (numeric_type(1) << bit));
+      Bits_64 changed = Hash(key).get_value() ^ Hash(flipped).get_value();
+
+      while (changed) {
+        flips[__builtin_ctzg(changed)]++;
+        changed &= changed - 1;
+      }
+    }
+
+    for (Count out = 0; out < 64; out++) {
+      const Real_64 bias = Real_64(flips[out]) / Real_64(samples) - 0.5;
+      worst = Math::max(worst, bias < 0 ? -bias : bias);
+    }
+  }
+
+  return worst;
+}
+
+// Worst correlation between two output bits flipping together when a single
+// input bit flips (the bit independence criterion), for 8 byte keys.
+static Count pair_flips[64][64];
+
+auto bit_independence_bias(Count samples) -> Real_64 {
+  KeySource source;
+  Real_64 worst = 0.0;
+  for (Count bit = 0; bit < 64; bit++) {
+    for (Count j = 0; j < 64; j++) {
+      for (Count k = 0; k < 64; k++) {
+        pair_flips[j][k] = 0;
+      }
+    }
+
+    for (Count sample = 0; sample < samples; sample++) {
+      const Bits_64 key = source.next();
+      const Bits_64 changed = Hash(key).get_value() ^
+                              Hash(key ^ (Bits_64(1) << bit)).get_value();
+
+      // The diagonal holds the single bit flip counts.
+      for (Bits_64 outer = changed; outer; outer &= outer - 1) {
+        const Count j = __builtin_ctzg(outer);
+        for (Bits_64 inner = outer; inner; inner &= inner - 1) {
+          pair_flips[j][__builtin_ctzg(inner)]++;
+        }
+      }
+    }
+
+    for (Count j = 0; j < 64; j++) {
+      const Real_64 pj = Real_64(pair_flips[j][j]) / Real_64(samples);
+      for (Count k = j + 1; k < 64; k++) {
+        const Real_64 pk = Real_64(pair_flips[k][k]) / Real_64(samples);
+        const Real_64 pjk = Real_64(pair_flips[j][k]) / Real_64(samples);
+        const Real_64 variance = pj * (1 - pj) * pk * (1 - pk);
+        if (variance <= 0.0) {
+          return 1.0;
+        }
+
+        // Compare squared correlations to skip the square root.
+        const Real_64 covariance = pjk - pj * pk;
+        worst = Math::max(worst, covariance * covariance / variance);
+      }
+    }
+  }
+
+  return worst;
+}
+
+// Number of colliding pairs among the first `count` hashes when only `bits`
+// bits of each hash are kept, starting at bit `shift`.
+auto count_collisions(Count count, Count shift, Count bits) -> Count {
+  static Bits_64 masked[max_hash_count];
+  const Bits_64 mask = bits == 64 ? Bits_64(-1) : (Bits_64(1) << bits) - 1;
+  for (Count i = 0; i < count; i++) {
+    masked[i] = (hashes[i] >> shift) & mask;
+  }
+
+  Algorithm::sort(Access::Vector<Bits_64>(masked, count));
+  Count collisions = 0;
+  Count run = 1;
+  for (Count i = 1; i <= count; i++) {
+    if (i < count && masked[i] == masked[i - 1]) {
+      run++;
+      continue;
+    }
+
+    collisions += run * (run - 1) / 2;
+    run = 1;
+  }
+
+  return collisions;
+}
+
+// Accept up to twice the expected collisions of a random function plus a
+// little slack for sets where the expectation is close to 0.
+auto collision_limit(Count count, Count bits) -> Count {
+  Real_64 buckets = 1.0;
+  for (Count i = 0; i < bits; i++) {
+    buckets *= 2.0;
+  }
+
+  const Real_64 expected = Real_64(count) * Real_64(count - 1) / 2.0 / buckets;
+  return Count(expected * 2.0) + 4;
+}
+
+// Checks the full hash never collides and that both the low bits (map bucket
+// indexes) and high bits (frozen map tags) look random.
+auto check_distribution(Test::TestResult& result, Count count, Count bits)
+    -> void {
+  EXPECT_EQ(count_collisions(count, 0, 64), 0);
+  EXPECT(count_collisions(count, 0, bits) <= collision_limit(count, bits));
+  EXPECT(
+      count_collisions(count, 64 - bits, bits) <= collision_limit(count, bits));
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, avalanche) {
+  // Short keys, the 8 to 16 byte tail cases and the striped bulk path.
+  EXPECT(avalanche_bias(3, 2000, 1) < 0.1);
+  EXPECT(avalanche_bias(8, 2000, 1) < 0.1);
+  EXPECT(avalanche_bias(13, 2000, 1) < 0.1);
+  EXPECT(avalanche_bias(16, 2000, 1) < 0.1);
+  EXPECT(avalanche_bias(40, 1000, 3) < 0.1);
+  EXPECT(avalanche_bias(max_key_size, 1000, 73) < 0.1);
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, numeric_avalanche) {
+  EXPECT(numeric_avalanche_bias<Bits_32>(2000) < 0.1);
+  EXPECT(numeric_avalanche_bias<Bits_64>(2000) < 0.1);
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, bit_independence) {
+  EXPECT(bit_independence_bias(1000) < 0.05);
+}
+
+// The 17+ byte weakness documented on Core::Hash. Every fix tried cost 10 to
+// 40% on the block loop, so the strict 2 bit tests leave out the pairs that
+// can cancel and check them against their own recorded bounds instead. A
+// retune that fixes it for free should drop this.
+auto in_blind_spot(Count key_size, Count bit) -> Bool {
+  return key_size > 16 && bit % 64 >= 48;
+}
+
+// The same blind spot bit in words a multiple of 16 bytes apart. Today about 1
+// in 10 of these pairs cancel and no other pair ever does.
+auto is_blind_pair(Count key_size, Count a, Count b) -> Bool {
+  return in_blind_spot(key_size, a) && (b - a) % 128 == 0;
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, sparse_keys) {
+  // Every 32 byte key with at most 2 bits set outside the blind spot.
+  constexpr Count sparse_size = 32;
+  constexpr Count sparse_bits = sparse_size * 8;
+  Count count = 0;
+  Data::set(key_buffer, 0, sparse_size);
+  hashes[count++] = hash_bytes(key_buffer, sparse_size);
+  for (Count a = 0; a < sparse_bits; a++) {
+    if (in_blind_spot(sparse_size, a)) {
+      continue;
+    }
+
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+    hashes[count++] = hash_bytes(key_buffer, sparse_size);
+    for (Count b = a + 1; b < sparse_bits; b++) {
+      if (in_blind_spot(sparse_size, b)) {
+        continue;
+      }
+
+      key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+      hashes[count++] = hash_bytes(key_buffer, sparse_size);
+      key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+    }
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+  }
+  check_distribution(result, count, 32);
+
+  // The same keys with at least one bit in the blind spot. Keys that differ by
+  // a blind pair collide about 1 in 13 times, so only hold them to that.
+  count = 0;
+  for (Count a = 0; a < sparse_bits; a++) {
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+    if (in_blind_spot(sparse_size, a)) {
+      hashes[count++] = hash_bytes(key_buffer, sparse_size);
+    }
+
+    for (Count b = a + 1; b < sparse_bits; b++) {
+      if (!in_blind_spot(sparse_size, a) && !in_blind_spot(sparse_size, b)) {
+        continue;
+      }
+
+      key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+      hashes[count++] = hash_bytes(key_buffer, sparse_size);
+      key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+    }
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+  }
+  EXPECT(count_collisions(count, 0, 64) <= count / 10);
+
+  // Bulk keys with a single bit set.
+  count = 0;
+  Data::set(key_buffer, 0, max_key_size);
+  for (Count a = 0; a < max_key_size * 8; a++) {
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+    hashes[count++] = hash_bytes(key_buffer, max_key_size);
+    key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+  }
+  check_distribution(result, count, 32);
+
+  // Every 64 bit integer with at most 2 bits set.
+  count = 0;
+  hashes[count++] = Hash(Bits_64(0)).get_value();
+  for (Count a = 0; a < 64; a++) {
+    hashes[count++] = Hash(Bits_64(1) << a).get_value();
+    for (Count b = a + 1; b < 64; b++) {
+      hashes[count++] = Hash((Bits_64(1) << a) | (Bits_64(1) << b)).get_value();
+    }
+  }
+  check_distribution(result, count, 24);
+
+  // Runs of zeros only differ by their length.
+  count = 0;
+  for (Count size = 0; size <= max_key_size * 2; size++) {
+    hashes[count++] = hash_bytes(key_buffer, size);
+  }
+  check_distribution(result, count, 24);
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, cyclic_keys) {
+  // Keys made of a short random cycle repeated 8 times.
+  const Count cycles[] = {4, 5, 8, 12, 16, 17};
+  KeySource source;
+  for (Count cycle : cycles) {
+    const Count size = cycle * 8;
+    constexpr Count count = 20000;
+    for (Count i = 0; i < count; i++) {
+      source.fill(key_buffer, cycle);
+      for (Count offset = cycle; offset < size; offset++) {
+        key_buffer[offset] = key_buffer[offset - cycle];
+      }
+      hashes[i] = hash_bytes(key_buffer, size);
+    }
+    check_distribution(result, count, 32);
+  }
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, differential) {
+  // No 1 or 2 bit change to a key should give the same hash, other than blind
+  // pairs which must stay under 1 in 6.
+  KeySource source;
+  const Count sizes[] = {8, 16, 24, 40};
+  for (Count size : sizes) {
+    const Count bits = size * 8;
+    Count matches = 0;
+    Count blind_matches = 0;
+    Count blind_pairs = 0;
+    for (Count sample = 0; sample < 100; sample++) {
+      source.fill(key_buffer, size);
+      const Bits_64 base = hash_bytes(key_buffer, size);
+      for (Count a = 0; a < bits; a++) {
+        key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+        matches += hash_bytes(key_buffer, size) == base;
+        for (Count b = a + 1; b < bits; b++) {
+          key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+          const auto same = hash_bytes(key_buffer, size) == base;
+          key_buffer[b / 8] ^= Bits_8(1 << (b % 8));
+
+          if (is_blind_pair(size, a, b)) {
+            blind_pairs++;
+            blind_matches += same;
+          } else {
+            matches += same;
+          }
+        }
+        key_buffer[a / 8] ^= Bits_8(1 << (a % 8));
+      }
+    }
+    EXPECT_EQ(matches, 0);
+    EXPECT(blind_matches * 6 <= blind_pairs);
+  }
+
+  Count matches = 0;
+  for (Count sample = 0; sample < 1000; sample++) {
+    const Bits_64 key = source.next();
+    const Bits_64 base = Hash(key).get_value();
+    for (Count a = 0; a < 64; a++) {
+      const Bits_64 once = key ^ (Bits_64(1) << a);
+      matches += Hash(once).get_value() == base;
+      for (Count b = a + 1; b < 64; b++) {
+        matches += Hash(once ^ (Bits_64(1) << b)).get_value() == base;
+      }
+    }
+  }
+  EXPECT_EQ(matches, 0);
+}
+
+auto is_word_byte(Bits_8 c) -> Bool {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+// Split text into runs of word characters and runs of symbols, roughly the
+// identifiers, numbers and operators the TTX tokenizer hands to the symbol
+// tables.
+auto collect_tokens(View::Bytes text, Dynamic::Set<View::Bytes>& tokens)
+    -> void {
+  Count start = 0;
+  for (Count i = 1; i <= text.get_size(); i++) {
+    const Bool boundary = i == text.get_size() ||
+                          is_word_byte(text[i]) != is_word_byte(text[start]);
+    if (!boundary) {
+      continue;
+    }
+
+    const auto token = text.slice(start, i - start);
+    if (token[0] != ' ' && token[0] != '\n') {
+      tokens.insert(token);
+    }
+    start = i;
+  }
+}
+
+// Every quoted string directly followed by a colon.
+auto collect_json_keys(View::Bytes text, Dynamic::Set<View::Bytes>& keys)
+    -> void {
+  for (Count i = 0; i < text.get_size(); i++) {
+    if (text[i] != '"') {
+      continue;
+    }
+
+    Count end = i + 1;
+    while (end < text.get_size() && text[end] != '"') {
+      end += text[end] == '\\' ? 2 : 1;
+    }
+    if (end + 1 < text.get_size() && text[end + 1] == ':') {
+      keys.insert(text.slice(i + 1, end - i - 1));
+    }
+    i = end;
+  }
+}
+
+auto hash_corpus(const Dynamic::Set<View::Bytes>& corpus) -> Count {
+  Count count = 0;
+  for (const auto& key : corpus) {
+    hashes[count++] = Hash(key).get_value();
+  }
+
+  return count;
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, ttx_tokens) {
+  const View::Bytes sources[] = {
+    "validation/data/ttx/source.ttx"_view,
+    "validation/data/ttx/png.ttx"_view,
+    "validation/data/ttx/types/Base.ttx"_view,
+    "validation/data/ttx/types/Dict.ttx"_view,
+    "validation/data/ttx/types/Func.ttx"_view,
+    "validation/data/ttx/types/List.ttx"_view,
+  };
+
+  File files[Data::array_size(sources)];
+  Dynamic::Set<View::Bytes> tokens;
+  for (Count i = 0; i < Data::array_size(sources); i++) {
+    ASSERT(files[i].read(sources[i]));
+    collect_tokens(files[i].get_view(), tokens);
+  }
+
+  const Count count = hash_corpus(tokens);
+  ASSERT(count > 100);
+  check_distribution(result, count, 12);
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, json_keys) {
+  const View::Bytes sources[] = {
+    "validation/data/json/init_rpc.json"_view,
+    "validation/data/json/initialized_rpc.json"_view,
+    "validation/data/json/test.json"_view,
+    "validation/data/json/tokenize_rpc.json"_view,
+  };
+
+  File files[Data::array_size(sources)];
+  Dynamic::Set<View::Bytes> keys;
+  for (Count i = 0; i < Data::array_size(sources); i++) {
+    ASSERT(files[i].read(sources[i]));
+    collect_json_keys(files[i].get_view(), keys);
+  }
+
+  const Count count = hash_corpus(keys);
+  ASSERT(count > 50);
+  check_distribution(result, count, 10);
+}
+
+PERIMORTEM_UNIT_TEST(HashQuality, generated_identifiers) {
+  // The real corpora are small so pad them out with the kind of names code
+  // generators produce: a shared prefix and a counter.
+  const View::Bytes prefixes[] = {
+    "field_"_view, "get"_view, "m_value"_view, "textDocument/"_view,
+  };
+
+  constexpr Count per_prefix = max_hash_count / 4;
+  Count count = 0;
+  for (const auto& prefix : prefixes) {
+    Data::copy(key_buffer, prefix.get_data(), prefix.get_size());
+    for (Count i = 0; i < per_prefix; i++) {
+      // Write the counter in decimal after the prefix.
+      Bits_8 digits[20];
+      Count digit_count = 0;
+      Count value = i;
+      do {
+        digits[digit_count++] = Bits_8('0' + value % 10);
+        value /= 10;
+      } while (value);
+
+      Count size = prefix.get_size();
+      while (digit_count) {
+        key_buffer[size++] = digits[--digit_count];
+      }
+      hashes[count++] = hash_bytes(key_buffer, size);
+    }
+  }
+
+  check_distribution(result, count, 24);
+}
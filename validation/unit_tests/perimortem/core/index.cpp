@@ -0,0 +1,157 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/algorithm/index.hpp"
+
+#include "validation/unit_test.hpp"
+
+#include <stdlib.h>
+
+#include "perimortem/core/algorithm/sort.hpp"
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+using namespace Perimortem::Core;
+
+using namespace Validation;
+
+static Harness AlgoIndex = {
+  .name = "Core::Algorithm::SearchIndex"_view,
+};
+
+// Reference lower bound using a linear scan.
+template <typename type>
+auto linear_lower_bound(View::Vector<type> sorted, type value) -> Count {
+  for (Count i = 0; i < sorted.get_size(); i++) {
+    if (!(value > sorted[i])) {
+      return i;
+    }
+  }
+
+  return sorted.get_size();
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, empty) {
+  Algorithm::SearchIndex<Bits_32> index(View::Vector<Bits_32>{});
+
+  EXPECT_EQ(index.get_size(), 0);
+  EXPECT_EQ(index.get_memory_consumption(), 0);
+  EXPECT_EQ(index.lower_bound(Bits_32(7)), 0);
+  EXPECT_NOT(index.contains(Bits_32(7)));
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, single_node) {
+  Bits_32 keys[] = {2, 4, 4, 8, 16};
+  Algorithm::SearchIndex<Bits_32> index = View::Vector<Bits_32>(keys);
+
+  EXPECT_EQ(index.get_height(), 1);
+  EXPECT_EQ(index.lower_bound(Bits_32(0)), 0);
+  EXPECT_EQ(index.lower_bound(Bits_32(2)), 0);
+  EXPECT_EQ(index.lower_bound(Bits_32(3)), 1);
+  EXPECT_EQ(index.lower_bound(Bits_32(4)), 1);
+  EXPECT_EQ(index.lower_bound(Bits_32(5)), 3);
+  EXPECT_EQ(index.lower_bound(Bits_32(16)), 4);
+  EXPECT_EQ(index.lower_bound(Bits_32(17)), 5);
+
+  EXPECT(index.contains(Bits_32(8)));
+  EXPECT_NOT(index.contains(Bits_32(9)));
+  EXPECT_NOT(index.contains(Bits_32(100)));
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, matches_linear_search) {
+  constexpr Count item_count = 5003;
+  static Bits_64 keys[item_count];
+
+  // Sparse keys with runs of duplicates to exercise separators.
+  srand(26);
+  for (Count i = 0; i < item_count; i++) {
+    keys[i] = Bits_64(rand() % 20000);
+  }
+  Algorithm::sort(keys);
+
+  // Sizes around the node and layer boundaries for 64 bit keys.
+  const Count sizes[] = {1, 8, 9, 72, 73, 600, item_count};
+  const auto sorted = View::Vector<Bits_64>(keys);
+  for (Count size : sizes) {
+    Algorithm::SearchIndex<Bits_64> index(sorted.slice(0, size));
+    ASSERT_EQ(index.get_size(), size);
+
+    for (Bits_64 value = 0; value < 20002; value += 3) {
+      ASSERT_EQ(
+          index.lower_bound(value),
+          linear_lower_bound(sorted.slice(0, size), value));
+    }
+  }
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, byte_keys) {
+  Bits_8 keys[200];
+  for (Count i = 0; i < 200; i++) {
+    keys[i] = Bits_8(i + 20);
+  }
+
+  Algorithm::SearchIndex<Bits_8> index = View::Vector<Bits_8>(keys);
+  EXPECT_EQ(index.get_height(), 2);
+
+  for (Count value = 0; value < 256; value++) {
+    ASSERT_EQ(
+        index.lower_bound(Bits_8(value)),
+        linear_lower_bound(View::Vector<Bits_8>(keys), Bits_8(value)));
+    if (value >= 20 && value < 220) {
+      ASSERT(index.contains(Bits_8(value)));
+    } else {
+      ASSERT_NOT(index.contains(Bits_8(value)));
+    }
+  }
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, batched_lookups) {
+  constexpr Count item_count = 3001;
+  static Signed_32 keys[item_count];
+  for (Count i = 0; i < item_count; i++) {
+    keys[i] = Signed_32(i * 2) - 1000;
+  }
+
+  Algorithm::SearchIndex<Signed_32> index = View::Vector<Signed_32>(keys);
+
+  // Use an odd number of queries so the last group is partial.
+  constexpr Count query_count = 1001;
+  static Signed_32 queries[query_count];
+  for (Count i = 0; i < query_count; i++) {
+    queries[i] = Signed_32(i * 7) - 1500;
+  }
+
+  static Count results[query_count];
+  static Bool found[query_count];
+  index.lower_bound(
+      View::Vector<Signed_32>(queries), Access::Vector<Count>(results));
+  index.contains(View::Vector<Signed_32>(queries), Access::Vector<Bool>(found));
+
+  for (Count i = 0; i < query_count; i++) {
+    ASSERT_EQ(results[i], index.lower_bound(queries[i]));
+    ASSERT_EQ(found[i], index.contains(queries[i]));
+  }
+}
+
+PERIMORTEM_UNIT_TEST(AlgoIndex, leak_test) {
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+
+  {
+    static Bits_32 keys[10000];
+    for (Count i = 0; i < 10000; i++) {
+      keys[i] = Bits_32(i);
+    }
+
+    Algorithm::SearchIndex<Bits_32> index = View::Vector<Bits_32>(keys);
+    Algorithm::SearchIndex<Bits_32> moved = Data::take(index);
+    EXPECT_EQ(index.get_size(), 0);
+    EXPECT_EQ(moved.get_size(), 10000);
+    EXPECT(moved.contains(Bits_32(9999)));
+
+    moved.build(View::Vector<Bits_32>(keys).slice(0, 10));
+    EXPECT_EQ(moved.get_size(), 10);
+  }
+
+  auto post_test_memory = Bibliotheca::allocated_memory();
+  EXPECT_EQ(pre_test_memory, post_test_memory);
+}
@@ -7,6 +7,7 @@
 
 #include "perimortem/core/static/bytes.hpp"
 #include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/math.hpp"
 #include "perimortem/core/null_terminated.hpp"
 #include "perimortem/core/writer/serial.hpp"
 
@@ -170,6 +171,64 @@ PERIMORTEM_UNIT_TEST(CoreSerialReader, read_from_empty) {
   EXPECT(Test::error_contains(error_message));
 }
 
+// Hands out a copy of a few bytes at a time so reads have to cross windows.
+class WindowStream : public Reader::Stream {
+ public:
+  WindowStream(View::Bytes source) : source(source) {}
+
+  auto fetch(Count offset, Count) -> View::Bytes override {
+    const Count size = Math::min(window_size, source.get_size() - offset);
+    Data::copy(window, source.get_data() + offset, size);
+    fetches++;
+    return View::Bytes(window, size);
+  }
+
+  auto get_size() const -> Count override { return source.get_size(); }
+
+  static constexpr Count window_size = 12;
+  Bits_8 window[window_size];
+  View::Bytes source;
+  Count fetches = 0;
+};
+
+PERIMORTEM_UNIT_TEST(CoreSerialReader, stream_reads) {
+  WindowStream stream(
+      "\x21\x0A"
+      "Perimortem"
+      "\x01\x04"
+      "\x12\xE8\x03"
+      "\x21\x05"
+      "Tests"_view);
+  Reader::Serial reader(stream);
+
+  EXPECT_EQ(reader.read_blob(), "Perimortem"_view);
+  EXPECT_EQ(reader.read_value(), 4);
+  EXPECT_EQ(reader.read_value(), -1000);
+  EXPECT_EQ(reader.read_blob(), "Tests"_view);
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+  EXPECT_EQ(stream.fetches, Count(2));
+
+  reader.reset();
+  EXPECT_EQ(reader.read_blob(), "Perimortem"_view);
+  EXPECT_EQ(stream.fetches, Count(3));
+}
+
+PERIMORTEM_UNIT_TEST(CoreSerialReader, stream_large_blob) {
+  WindowStream stream("\x21\x0D" "Larger than 12"_view);
+  Reader::Serial reader(stream);
+  auto scope_attribution = Diagnostics::Log::set_attribution();
+
+  // Blobs are views into the window so they can't be larger than it.
+  EXPECT_EQ(reader.read_blob(), ""_view);
+  EXPECT_NOT(reader.is_valid());
+
+  constexpr auto error_message =
+      "Serial read of blob sized 13 bytes overran source buffer at location "
+      "2. source_size=16 blob_size=13"_view;
+  EXPECT(Test::error_contains(error_message));
+}
+
 static Harness CoreSerialWriter = {
   .name = "Core::Writer::Serial"_view,
 };
@@ -257,3 +316,25 @@ PERIMORTEM_UNIT_TEST(CoreSerialWriter, overflow) {
 
   EXPECT_NOT(writer.is_valid());
 }
+
+PERIMORTEM_UNIT_TEST(CoreSerialWriter, reserve_blob) {
+  Static::Bytes<16> buffer;
+  Writer::Serial writer(buffer);
+
+  Access::Bytes blob = writer.reserve_blob(10);
+  EXPECT_EQ(blob.get_size(), 10);
+  Data::copy(blob.get_data(), "Perimortem"_view.get_data(), 10);
+  writer << 4;
+
+  EXPECT(writer.is_valid());
+  EXPECT_EQ(writer.get_location(), 14);
+  EXPECT_HEX(
+      View::Bytes(buffer.get_data(), 14),
+      "\x21\x0A"
+      "Perimortem"
+      "\x01\x04"_view);
+
+  // Space that doesn't fit invalidates the writer instead.
+  EXPECT_EQ(writer.reserve_blob(8).get_size(), 0);
+  EXPECT_NOT(writer.is_valid());
+}
@@ -28,6 +28,73 @@ PERIMORTEM_UNIT_TEST(CoreTextualReader, integers) {
   EXPECT_EQ(reader.read_signed(), Signed_64(9876543210ULL));
 }
 
+PERIMORTEM_UNIT_TEST(CoreTextualReader, integer_limits) {
+  Reader::Textual reader(
+      "9223372036854775807 -9223372036854775808 18446744073709551615 "
+      "0000000000000000000000042 12345678,87654321"_view);
+
+  EXPECT_EQ(reader.read_signed(), Signed_64(9223372036854775807LL));
+  EXPECT_EQ(reader.read_signed(), Signed_64(-9223372036854775807LL - 1));
+  EXPECT_EQ(reader.read_unsigned(), Bits_64(18446744073709551615ULL));
+  EXPECT_EQ(reader.read_unsigned(), Bits_64(42));
+  EXPECT_EQ(reader.read_unsigned(), Bits_64(12345678));
+  EXPECT_EQ(reader.read_byte(), Bits_8(','));
+  EXPECT_EQ(reader.read_unsigned(), Bits_64(87654321));
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextualReader, integer_round_trip) {
+  // Every length of number, followed by every kind of text so the digit runs
+  // end inside, at and past the edges of the blocks.
+  Static::Bytes<64> buffer;
+  Bits_64 state = 0x2545F4914F6CDD1D;
+  for (Count i = 0; i < 20000; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    const Bits_64 value = state >> (state % 64);
+    Writer::Textual writer(buffer.get_access());
+    writer << value;
+    for (Count pad = 0; pad < i % 24; pad++) {
+      writer << "x"_view;
+    }
+
+    Reader::Textual reader(buffer.get_view().slice(0, writer.get_location()));
+    ASSERT_EQ(reader.read_unsigned(), value);
+    ASSERT_EQ(reader.read_byte(), (i % 24) ? Bits_8('x') : Bits_8(0));
+  }
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextualReader, read_array) {
+  Reader::Textual reader("1, 22,333\n-4444\t55555 ] 6"_view);
+
+  Signed_64 values[8];
+  EXPECT_EQ(reader.read_array(Access::Vector<Signed_64>(values)), 5);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[2], 333);
+  EXPECT_EQ(values[3], -4444);
+  EXPECT_EQ(values[4], 55555);
+  EXPECT_EQ(reader.read_byte(), Bits_8(']'));
+  EXPECT(reader.is_valid());
+
+  // Stops once the output is full.
+  Reader::Textual reals("0.5,-2e3, inf, 7"_view);
+  Real_64 real_values[3];
+  EXPECT_EQ(reals.read_array(Access::Vector<Real_64>(real_values)), 3);
+  EXPECT_EQ(real_values[1], -2000.0);
+  EXPECT_EQ(real_values[2], __builtin_inf());
+  EXPECT_EQ(reals.read_byte(), Bits_8(','));
+  EXPECT_EQ(reals.read_unsigned(), Bits_64(7));
+
+  // A sign with no digits is a failure rather than the end of the list.
+  Reader::Textual broken("1 2 - 3"_view);
+  Signed_64 broken_values[4];
+  EXPECT_EQ(broken.read_array(Access::Vector<Signed_64>(broken_values)), 2);
+  EXPECT_NOT(broken.is_valid());
+}
+
 PERIMORTEM_UNIT_TEST(CoreTextualReader, integers_and_text) {
   Reader::Textual reader("count: 412010 items"_view);
 
@@ -65,6 +132,106 @@ PERIMORTEM_UNIT_TEST(CoreTextualReader, floats) {
   EXPECT(reader.is_valid());
 }
 
+PERIMORTEM_UNIT_TEST(CoreTextualReader, float_exponents) {
+  Reader::Textual reader(
+      "1e23 -2.5E-3 7e+2 1.7976931348623157e308 5e-324"_view);
+
+  EXPECT_EQ(reader.read_real_64(), Real_64(1e23));
+  EXPECT_EQ(reader.read_real_64(), Real_64(-2.5e-3));
+  EXPECT_EQ(reader.read_real_64(), Real_64(700.0));
+  EXPECT_EQ(reader.read_real_64(), Real_64(1.7976931348623157e308));
+  EXPECT_EQ(reader.read_real_64(), Real_64(5e-324));
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextualReader, float_limits) {
+  // Past the largest real rounds to infinity and past the smallest subnormal
+  // rounds to zero, the same as strtod.
+  Reader::Textual reader("1e400 -1e400 1e-400 3.5e38 inf -inf nan"_view);
+
+  EXPECT_EQ(reader.read_real_64(), __builtin_inf());
+  EXPECT_EQ(reader.read_real_64(), -__builtin_inf());
+  EXPECT_EQ(reader.read_real_64(), Real_64(0.0));
+  EXPECT_EQ(reader.read_real_32(), __builtin_inff());
+  EXPECT_EQ(reader.read_real_64(), __builtin_inf());
+  EXPECT_EQ(reader.read_real_64(), -__builtin_inf());
+
+  const Real_64 not_a_number = reader.read_real_64();
+  EXPECT(not_a_number != not_a_number);
+  EXPECT(reader.is_valid());
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextualReader, float_long_digits) {
+  // 2^53 + 1 sits exactly between two doubles so it rounds to even, but any
+  // digit after it tips it up.
+  Reader::Textual ties(
+      "9007199254740993 9007199254740993.0000000000000000000001"_view);
+  EXPECT_EQ(ties.read_real_64(), Real_64(9007199254740992.0));
+  EXPECT_EQ(ties.read_real_64(), Real_64(9007199254740994.0));
+
+  // Exactly halfway between zero and the smallest subnormal, where only the
+  // digits far past the 19 kept by the fast path decide which way to round.
+  constexpr auto halfway =
+      "2.4703282292062327208828439643411068618252990130716238221279284125033775"
+      "363510437593264991818081799618989828234772285886546332835517796989819938"
+      "739800539093906315035659515570226392290858392449105184435931802849936536"
+      "152500319370457678249219365623669863658480757001585769269903706311928279"
+      "558551332927834338409351978015531246597263579574622766465272827220056374"
+      "006485499977096599470454020828166226237857393450736339007967761930577506"
+      "740176324673600968951340535537458516661134223766678604162159680461914467"
+      "291840300530057530849048765391711386591646239524912623653881879636239373"
+      "280423891018672348497668235089863388587925628302755995657524455507255189"
+      "313690836254779186948667994968324049705821028513185451396213837722826145"
+      "437693412532098591327667236328125"_view;
+
+  Static::Bytes<1600> text;
+  Writer::Textual writer(text.get_access());
+  writer << halfway << "e-324 "_view << halfway << "1e-324"_view;
+  ASSERT(writer.is_valid());
+
+  Reader::Textual reader(text.get_view().slice(0, writer.get_location()));
+  EXPECT_EQ(reader.read_real_64(), Real_64(0.0));
+  EXPECT_EQ(reader.read_real_64(), Real_64(5e-324));
+  EXPECT(reader.is_valid());
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextualReader, float_round_trip) {
+  Static::Bytes<32> buffer;
+
+  // Random bit patterns written out shortest and read back.
+  Bits_64 state = 0x9E3779B97F4A7C15;
+  for (Count i = 0; i < 10000; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    const Real_64 real = __builtin_bit_cast(Real_64, state);
+    if (real != real) {
+      continue;
+    }
+
+    Writer::Textual writer(buffer.get_access());
+    writer << real;
+    ASSERT(writer.is_valid());
+
+    Reader::Textual reader(buffer.get_view().slice(0, writer.get_location()));
+    ASSERT(__builtin_bit_cast(Bits_64, reader.read_real_64()) == state);
+
+    const Real_32 single = __builtin_bit_cast(Real_32, Bits_32(state));
+    if (single != single) {
+      continue;
+    }
+
+    Writer::Textual short_writer(buffer.get_access());
+    short_writer << single;
+    Reader::Textual short_reader(
+        buffer.get_view().slice(0, short_writer.get_location()));
+    ASSERT(__builtin_bit_cast(Bits_32, short_reader.read_real_32()) ==
+           Bits_32(state));
+  }
+}
+
 PERIMORTEM_UNIT_TEST(CoreTextualReader, prevent_overflow) {
   Reader::Textual reader("Hello"_view);
 
@@ -182,6 +349,40 @@ PERIMORTEM_UNIT_TEST(CoreTextual, integers_and_text) {
   EXPECT_TEXT(buffer, "Test Value: 412010 units"_view);
 }
 
+PERIMORTEM_UNIT_TEST(CoreTextual, integer_limits) {
+  Static::Bytes<61> buffer;
+  Writer::Textual writer(buffer.get_access());
+
+  writer << Signed_64(-9223372036854775807LL - 1) << " "_view
+         << Bits_64(18446744073709551615ULL) << " "_view << Bits_64(100000000);
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(buffer.get_view().slice(0, writer.get_location()),
+              "-9223372036854775808 18446744073709551615 100000000"_view);
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextual, write_array) {
+  Static::Bytes<48> buffer;
+  Writer::Textual writer(buffer.get_access());
+
+  const Signed_64 values[] = {0, -1, 250, 1000000007};
+  const Real_64 reals[] = {0.5, 1e-9};
+  writer << "["_view;
+  writer.write_array(View::Vector<Signed_64>(values), ","_view);
+  writer << "] "_view;
+  writer.write_array(View::Vector<Real_64>(reals), ", "_view);
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(buffer.get_view().slice(0, writer.get_location()),
+              "[0,-1,250,1000000007] 0.5, 1e-9"_view);
+
+  // Running out of room part way through invalidates the writer.
+  Static::Bytes<8> small;
+  Writer::Textual small_writer(small.get_access());
+  small_writer.write_array(View::Vector<Signed_64>(values), ","_view);
+  EXPECT_NOT(small_writer.is_valid());
+}
+
 PERIMORTEM_UNIT_TEST(CoreTextual, boolean) {
   Static::Bytes<11> buffer;
   Writer::Textual writer(buffer.get_access());
@@ -206,8 +407,38 @@ PERIMORTEM_UNIT_TEST(CoreTextual, floats) {
   writer << Real_32(-2012.78102) << Real_64(-2012.78102);
 
   EXPECT(writer.is_valid());
-  EXPECT_TEXT(
-      buffer.get_view(), "12.080.0000812-2012.7810058-2012.78102\0\0"_view);
+  EXPECT_TEXT(buffer.get_view(),
+              "12.080.0000812-2012.781-2012.78102\0\0\0\0\0\0"_view);
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextual, shortest_floats) {
+  Static::Bytes<96> buffer;
+  Writer::Textual writer(buffer.get_access());
+
+  // Shortest text that reads back to the same value, switching to exponents
+  // once the number gets too big or too small to write out in full.
+  const auto space = " "_view;
+  writer << 0.1 << space << 1e20 << space << 1e21 << space << 1.5e-7 << space
+         << Real_32(0.3f) << space << -0.0 << space << 5e-324 << space
+         << 1.7976931348623157e308;
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(buffer.get_view().slice(0, writer.get_location()),
+              "0.1 100000000000000000000.0 1e21 1.5e-7 0.3 -0.0 5e-324 "
+              "1.7976931348623157e308"_view);
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextual, non_finite_floats) {
+  Static::Bytes<16> buffer;
+  Writer::Textual writer(buffer.get_access());
+
+  const auto space = " "_view;
+  writer << __builtin_inf() << space << -__builtin_inff() << space
+         << __builtin_nan("");
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(buffer.get_view().slice(0, writer.get_location()),
+              "inf -inf nan"_view);
 }
 
 PERIMORTEM_UNIT_TEST(CoreTextual, multiple_writers) {
@@ -235,3 +466,46 @@ PERIMORTEM_UNIT_TEST(CoreTextual, multiple_writers) {
   EXPECT_NOT(writers[0].is_valid());
   EXPECT(writers[1].is_valid());
 }
+
+PERIMORTEM_UNIT_TEST(CoreTextual, format) {
+  Static::Bytes<256> buffer;
+  Writer::Textual writer(buffer);
+
+  writer.format<"{} items at {}/{} with {} and {}{}{}, done={}">(
+      Bits_64(18446744073709551615ULL), -2000000000, Signed_16(-123),
+      "text"_view, 79.8106, 'x', 1.5f, False);
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(
+      buffer.get_view().slice(0, writer.get_location()),
+      "18446744073709551615 items at -2000000000/-123 with text and "
+      "79.8106x1.5, done=false"_view);
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextual, format_literals) {
+  Static::Bytes<64> buffer;
+  Writer::Textual writer(buffer);
+
+  writer.format<"">();
+  writer.format<"{{}} {}{{">(Bits_8(255));
+  writer.format<"{}">(""_view);
+
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(
+      buffer.get_view().slice(0, writer.get_location()), "{} 255{"_view);
+}
+
+PERIMORTEM_UNIT_TEST(CoreTextual, format_tight_buffer) {
+  // Too small for the worst case estimate but large enough for the actual
+  // text, so formatting has to fall back to writing piece by piece.
+  Static::Bytes<12> buffer;
+  Writer::Textual writer(buffer);
+
+  writer.format<"[{}, {}]">(Bits_64(7), -3.5);
+  EXPECT(writer.is_valid());
+  EXPECT_TEXT(
+      buffer.get_view().slice(0, writer.get_location()), "[7, -3.5]"_view);
+
+  writer.format<"{}">(Bits_64(12345));
+  EXPECT_NOT(writer.is_valid());
+}
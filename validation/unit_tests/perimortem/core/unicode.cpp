@@ -0,0 +1,180 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/core/algorithm/unicode.hpp"
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+using namespace Perimortem::Core;
+using namespace Validation;
+
+static Harness AlgoUnicode = {
+  .name = "Core::Algorithm::Unicode"_view,
+};
+
+// Straightforward decoder used as the reference for the vectorized checks.
+static auto reference_validate(View::Bytes src) -> Bool {
+  Count i = 0;
+  while (i < src.get_size()) {
+    const Bits_8 lead = src[i];
+    Count length;
+    Bits_32 code_point;
+    if (lead < 0x80) {
+      i++;
+      continue;
+    } else if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      code_point = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      code_point = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      code_point = lead & 0x07;
+    } else {
+      return false;
+    }
+
+    if (i + length > src.get_size()) {
+      return false;
+    }
+
+    for (Count j = 1; j < length; j++) {
+      if ((src[i + j] & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (src[i + j] & 0x3F);
+    }
+
+    constexpr Bits_32 smallest[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (code_point < smallest[length] || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+
+    i += length;
+  }
+
+  return true;
+}
+
+// Places a sequence at every offset around a block boundary.
+template <Count size>
+static auto check_everywhere(
+    Test::TestResult& result,
+    View::Bytes sequence,
+    Bool valid) -> void {
+  for (Count offset = 0; offset + sequence.get_size() <= size; offset++) {
+    Static::Bytes<size> text;
+    Data::set(text.get_data(), 'a', size);
+    Data::copy(text.get_data() + offset, sequence.get_data(),
+               sequence.get_size());
+    ASSERT(Algorithm::validate_utf8(text.get_view()) == valid);
+  }
+}
+
+PERIMORTEM_UNIT_TEST(AlgoUnicode, empty) {
+  EXPECT(Algorithm::validate_utf8(""_view));
+  EXPECT_EQ(Algorithm::utf16_length(""_view), 0);
+}
+
+PERIMORTEM_UNIT_TEST(AlgoUnicode, valid_sequences) {
+  EXPECT(Algorithm::validate_utf8("plain ascii text"_view));
+  check_everywhere<80>(result, "\xC3\xA9"_view, true);
+  check_everywhere<80>(result, "\xE2\x82\xAC"_view, true);
+  check_everywhere<80>(result, "\xF0\x9F\x98\x80"_view, true);
+  check_everywhere<80>(result, "\xF4\x8F\xBF\xBF"_view, true);
+  check_everywhere<80>(result, "\xED\x9F\xBF"_view, true);
+  check_everywhere<80>(result, "\xEE\x80\x80"_view, true);
+}
+
+PERIMORTEM_UNIT_TEST(AlgoUnicode, invalid_sequences) {
+  // Lone continuation and invalid leads.
+  check_everywhere<80>(result, "\x80"_view, false);
+  check_everywhere<80>(result, "\xFF"_view, false);
+  check_everywhere<80>(result, "\xF8\x88\x80\x80\x80"_view, false);
+  // Overlong encodings.
+  check_everywhere<80>(result, "\xC0\x80"_view, false);
+  check_everywhere<80>(result, "\xC1\xBF"_view, false);
+  check_everywhere<80>(result, "\xE0\x9F\xBF"_view, false);
+  check_everywhere<80>(result, "\xF0\x8F\xBF\xBF"_view, false);
+  // Surrogates and code points past U+10FFFF.
+  check_everywhere<80>(result, "\xED\xA0\x80"_view, false);
+  check_everywhere<80>(result, "\xF4\x90\x80\x80"_view, false);
+  check_everywhere<80>(result, "\xF5\x80\x80\x80"_view, false);
+  // Truncated sequences and stray continuations.
+  check_everywhere<80>(result, "\xE2\x82"_view, false);
+  check_everywhere<80>(result, "\xC3\xA9\xA9"_view, false);
+
+  // Sequences cut off by the end of the text.
+  EXPECT_NOT(Algorithm::validate_utf8("abc\xC3"_view));
+  EXPECT_NOT(Algorithm::validate_utf8(
+      "0123456789abcdef0123456789abcd\xE2\x82"_view));
+  EXPECT_NOT(Algorithm::validate_utf8(
+      "0123456789abcdef0123456789abcde\xF0"_view));
+}
+
+// Xorshift so the inputs are the same every run.
+static auto next_random(Bits_64& state) -> Bits_64 {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+PERIMORTEM_UNIT_TEST(AlgoUnicode, matches_reference) {
+  // Mostly valid text with the occasional random byte, so errors land at every
+  // position relative to the blocks.
+  constexpr View::Bytes pieces[] = {
+      "a"_view, "\n"_view, "\xC3\xA9"_view, "\xE2\x82\xAC"_view,
+      "\xF0\x9F\x98\x80"_view,
+  };
+
+  Bits_64 state = 0x2545F4914F6CDD1D;
+  Static::Bytes<256> text;
+  for (Count round = 0; round < 5000; round++) {
+    Count size = 0;
+    const Count target = next_random(state) % 200;
+    while (size < target) {
+      const auto piece = pieces[next_random(state) % 5];
+      Data::copy(text.get_data() + size, piece.get_data(), piece.get_size());
+      size += piece.get_size();
+    }
+
+    if (round % 2) {
+      text[next_random(state) % (size + 1)] = Bits_8(next_random(state));
+    }
+
+    const auto view = text.get_view().slice(0, size);
+    ASSERT(Algorithm::validate_utf8(view) == reference_validate(view));
+    ASSERT_EQ(Algorithm::utf16_length(view),
+              Algorithm::utf16_length_scalar(view));
+  }
+}
+
+PERIMORTEM_UNIT_TEST(AlgoUnicode, utf16_length) {
+  EXPECT_EQ(Algorithm::utf16_length("ascii"_view), 5);
+  EXPECT_EQ(Algorithm::utf16_length("caf\xC3\xA9"_view), 4);
+  EXPECT_EQ(Algorithm::utf16_length("\xE2\x82\xAC"_view), 1);
+  EXPECT_EQ(Algorithm::utf16_length("\xF0\x9F\x98\x80"_view), 2);
+
+  // 20 emoji cover a full vector block plus a scalar tail.
+  Static::Bytes<80> emoji;
+  for (Count i = 0; i < 20; i++) {
+    Data::copy(emoji.get_data() + i * 4, "\xF0\x9F\x98\x80"_view.get_data(),
+               4);
+  }
+  EXPECT_EQ(Algorithm::utf16_length(emoji.get_view()), 40);
+
+  // Ranges can be split anywhere and still add up.
+  const auto view = emoji.get_view();
+  for (Count split = 0; split <= view.get_size(); split++) {
+    ASSERT_EQ(Algorithm::utf16_length(view.slice(0, split)) +
+                  Algorithm::utf16_length(
+                      view.slice(split, view.get_size() - split)),
+              40);
+  }
+}
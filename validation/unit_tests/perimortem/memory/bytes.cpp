@@ -0,0 +1,219 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+#include "perimortem/core/reader/binary.hpp"
+#include "perimortem/core/reader/serial.hpp"
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/writer/binary.hpp"
+#include "perimortem/core/writer/serial.hpp"
+#include "perimortem/core/writer/textual.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/bytes_sink.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness DynamicBytes = {
+  .name = "Dynamic::Bytes"_view,
+};
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, short_payloads_stay_inline) {
+  const Count requests = Bibliotheca::check_out_requests();
+
+  Dynamic::Bytes empty;
+  Dynamic::Bytes name("alpha"_view);
+  Dynamic::Bytes full("0123456789abcdefghijklm"_view);
+  Dynamic::Bytes copy(name);
+  copy.concat("_beta"_view);
+
+  EXPECT(empty.is_inline());
+  EXPECT_EQ(empty.get_size(), 0);
+  EXPECT(name.is_inline());
+  EXPECT(name == "alpha"_view);
+  EXPECT(full.is_inline());
+  EXPECT_EQ(full.get_size(), Dynamic::Bytes::inline_capacity);
+  EXPECT(copy == "alpha_beta"_view);
+  EXPECT_EQ(Bibliotheca::check_out_requests(), requests);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, promotion) {
+  Dynamic::Bytes bytes;
+  for (Count i = 0; i < 100; i++) {
+    bytes.append(Bits_8(i));
+    if (i < Dynamic::Bytes::inline_capacity) {
+      EXPECT(bytes.is_inline());
+    } else {
+      EXPECT_NOT(bytes.is_inline());
+    }
+  }
+
+  ASSERT_EQ(bytes.get_size(), 100);
+  EXPECT(bytes.get_capacity() >= 100);
+  for (Count i = 0; i < 100; i++) {
+    ASSERT_EQ(bytes[i], Bits_8(i));
+  }
+
+  // Only forgetting the contents or resetting comes back inline, shrinking
+  // keeps the block so the old size can be restored.
+  bytes.resize(4);
+  EXPECT_NOT(bytes.is_inline());
+  bytes.resize(100);
+  EXPECT_EQ(bytes[99], Bits_8(99));
+
+  bytes.forgetful_resize(8);
+  EXPECT(bytes.is_inline());
+  EXPECT_EQ(bytes.get_size(), 8);
+
+  bytes.forgetful_resize(64);
+  EXPECT_NOT(bytes.is_inline());
+  bytes.reset();
+  EXPECT(bytes.is_inline());
+  EXPECT_EQ(bytes.get_size(), 0);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, copy_and_move) {
+  const auto long_text = "a payload that is too long to be stored inline"_view;
+
+  Dynamic::Bytes short_bytes("short"_view);
+  Dynamic::Bytes long_bytes(long_text);
+  const auto block = long_bytes.get_view().get_data();
+
+  // Moving a block hands it over rather than copying.
+  Dynamic::Bytes moved_long(static_cast<Dynamic::Bytes&&>(long_bytes));
+  EXPECT(moved_long == long_text);
+  EXPECT(moved_long.get_view().get_data() == block);
+  EXPECT(long_bytes.is_inline());
+  EXPECT_EQ(long_bytes.get_size(), 0);
+
+  Dynamic::Bytes moved_short;
+  moved_short = static_cast<Dynamic::Bytes&&>(short_bytes);
+  EXPECT(moved_short == "short"_view);
+  EXPECT_EQ(short_bytes.get_size(), 0);
+
+  // Assigning across storage types both ways.
+  moved_short = moved_long;
+  EXPECT(moved_short == long_text);
+  EXPECT_NOT(moved_short.is_inline());
+  moved_short = "tiny"_view;
+  EXPECT(moved_short == "tiny"_view);
+  EXPECT(moved_short.is_inline());
+
+  moved_long = static_cast<Dynamic::Bytes&&>(moved_short);
+  EXPECT(moved_long == "tiny"_view);
+  EXPECT(moved_long.is_inline());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, edits) {
+  Dynamic::Bytes bytes("hello world"_view);
+  bytes.convert('o', '0');
+  EXPECT(bytes == "hell0 w0rld"_view);
+
+  bytes.shrink(6);
+  EXPECT(bytes == "w0rld"_view);
+  EXPECT(bytes.slice(1, 3) == "0rl"_view);
+
+  // Assigning a piece of itself.
+  bytes = bytes.slice(2, 3);
+  EXPECT(bytes == "rld"_view);
+
+  Dynamic::Bytes long_bytes("a payload too long to be stored inline"_view);
+  long_bytes = long_bytes.slice(2, 7);
+  EXPECT(long_bytes == "payload"_view);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, map_keys) {
+  // Keys move between tables as the map grows.
+  Dynamic::Map<Dynamic::Bytes, Count> names;
+  Bits_8 name[32] = {'n', 'a', 'm', 'e', '_'};
+  for (Count i = 0; i < 1000; i++) {
+    const Count size = 5 + i % 27;
+    for (Count j = 5; j < size; j++) {
+      name[j] = Bits_8('a' + (i + j) % 26);
+    }
+    name[size - 1] = Bits_8('0' + i % 10);
+    names.insert(View::Bytes(name, size), i);
+  }
+
+  Count found = 0;
+  for (const auto& entry : names) {
+    found += entry.value < 1000 &&
+             entry.key.get_size() == 5 + entry.value % 27;
+  }
+  EXPECT_EQ(found, names.get_size());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, textual_sink) {
+  Static::Bytes<4096> fixed_buffer;
+  Writer::Textual fixed(fixed_buffer);
+
+  const Count requests = Bibliotheca::check_out_requests();
+  Dynamic::Bytes output;
+  Dynamic::BytesSink sink(output);
+  Writer::Textual writer(sink);
+  for (Count i = 0; i < 500; i++) {
+    writer << Bits_64(i * 7919) << ',';
+    fixed << Bits_64(i * 7919) << ',';
+  }
+
+  ASSERT(writer.is_valid());
+  output.resize(writer.get_location());
+  EXPECT_TEXT(output.get_view(), View::Bytes(fixed));
+
+  // Growing geometrically only needs a handful of blocks.
+  EXPECT(Bibliotheca::check_out_requests() - requests < 12);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, binary_sink) {
+  Dynamic::Bytes output;
+  Dynamic::BytesSink sink(output);
+  Writer::Binary<Data::ByteOrder::Big> writer(sink);
+
+  // Alignment is from the start of the output so the first value is padded.
+  writer << Bits_8(0xAB);
+  for (Count i = 0; i < 100; i++) {
+    writer << Bits_64(i);
+  }
+
+  ASSERT(writer.is_valid());
+  EXPECT_EQ(writer.get_location(), Count(808));
+  output.resize(writer.get_location());
+
+  Reader::Binary<Data::ByteOrder::Big> reader(output.get_view());
+  EXPECT_EQ(reader.read_bits_8(), Bits_8(0xAB));
+  Count mismatches = 0;
+  for (Count i = 0; i < 100; i++) {
+    mismatches += reader.read_bits_64() != i;
+  }
+  EXPECT_EQ(mismatches, Count(0));
+  EXPECT(reader.is_empty());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicBytes, serial_sink) {
+  Dynamic::Bytes output;
+  Dynamic::BytesSink sink(output);
+  Writer::Serial writer(sink);
+  for (Count i = 0; i < 100; i++) {
+    writer << Bits_64(i * 1000) << "Perimortem"_view;
+  }
+
+  ASSERT(writer.is_valid());
+  output.resize(writer.get_location());
+
+  Reader::Serial reader(output.get_view());
+  Count mismatches = 0;
+  for (Count i = 0; i < 100; i++) {
+    mismatches += reader.read_value() != Signed_64(i * 1000);
+    mismatches += reader.read_blob() == "Perimortem"_view ? 0 : 1;
+  }
+  EXPECT_EQ(mismatches, Count(0));
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+}
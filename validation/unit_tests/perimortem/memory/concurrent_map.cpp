@@ -0,0 +1,142 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/thread/worker.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/concurrent/map.hpp"
+#include "perimortem/memory/dynamic/bytes.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness ConcurrentMap = {
+  .name = "Concurrent::Map"_view,
+};
+
+PERIMORTEM_UNIT_TEST(ConcurrentMap, basic_operations) {
+  Concurrent::Map<Signed_32, Signed_32> int_map;
+
+  EXPECT_EQ(int_map.get_size(), 0);
+  EXPECT_NOT(int_map.contains(1));
+  EXPECT_EQ(int_map.find_or_default(1, -1), -1);
+
+  for (Signed_32 i = 0; i < 1000; i++) {
+    int_map.insert(i, i * 2);
+  }
+  EXPECT_EQ(int_map.get_size(), 1000);
+
+  for (Signed_32 i = 0; i < 1000; i++) {
+    ASSERT(int_map.contains(i));
+    ASSERT_EQ(int_map.find_or_default(i, -1), i * 2);
+  }
+
+  EXPECT(int_map.erase(10));
+  EXPECT_NOT(int_map.erase(10));
+  EXPECT_NOT(int_map.contains(10));
+  EXPECT_EQ(int_map.get_size(), 999);
+
+  int_map.update(10, [](Signed_32& value) { value += 5; });
+  int_map.update(11, [](Signed_32& value) { value += 5; });
+  EXPECT_EQ(int_map.find_or_default(10, -1), 5);
+  EXPECT_EQ(int_map.find_or_default(11, -1), 27);
+
+  Signed_32 seen = 0;
+  EXPECT(int_map.visit(12, [&](const Signed_32& value) { seen = value; }));
+  EXPECT_NOT(int_map.visit(-12, [&](const Signed_32& value) { seen = 0; }));
+  EXPECT_EQ(seen, 24);
+
+  int_map.reset();
+  EXPECT_EQ(int_map.get_size(), 0);
+}
+
+PERIMORTEM_UNIT_TEST(ConcurrentMap, byte_keys) {
+  Concurrent::Map<Dynamic::Bytes, Signed_32> text_map;
+
+  text_map.insert("Hello"_view, 1);
+  text_map.insert("World"_view, 2);
+
+  EXPECT_EQ(text_map.find_or_default("Hello"_view, 0), 1);
+  EXPECT_EQ(text_map.find_or_default("World"_view, 0), 2);
+  EXPECT_NOT(text_map.contains("Missing"_view));
+}
+
+// Shared state for the threaded tests since worker jobs don't take arguments.
+static constexpr Count lane_count = 4;
+static constexpr Signed_32 keys_per_lane = 2048;
+static Concurrent::Map<Signed_32, Signed_32> shared_map;
+static Count next_lane = 0;
+static Count error_count = 0;
+static Bits_32 writer_done = 0;
+
+static auto claim_lane() -> Signed_32 {
+  return Signed_32(__atomic_fetch_add(&next_lane, 1, __ATOMIC_RELAXED));
+}
+
+PERIMORTEM_UNIT_TEST(ConcurrentMap, threaded_writers) {
+  shared_map.reset();
+  shared_map.ensure_capacity(lane_count * keys_per_lane);
+  next_lane = 0;
+
+  {
+    // Each worker writes its own range of keys.
+    Thread::Worker workers[lane_count];
+    for (Count i = 0; i < lane_count; i++) {
+      workers[i] = Thread::Worker::start("map_writer"_view, []() {
+        const Signed_32 start = claim_lane() * keys_per_lane;
+        for (Signed_32 key = start; key < start + keys_per_lane; key++) {
+          shared_map.insert(key, key + 1);
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(shared_map.get_size(), lane_count * keys_per_lane);
+  for (Signed_32 key = 0; key < lane_count * keys_per_lane; key++) {
+    ASSERT_EQ(shared_map.find_or_default(key, -1), key + 1);
+  }
+}
+
+PERIMORTEM_UNIT_TEST(ConcurrentMap, readers_during_writes) {
+  shared_map.reset();
+  shared_map.ensure_capacity(keys_per_lane);
+  error_count = 0;
+  writer_done = 0;
+
+  {
+    // A single writer keeps adding and removing keys while readers check that
+    // any value they see is consistent with its key.
+    Thread::Worker writer = Thread::Worker::start("map_writer"_view, []() {
+      for (Signed_32 round = 0; round < 8; round++) {
+        for (Signed_32 key = 0; key < keys_per_lane; key++) {
+          shared_map.insert(key, key * 3);
+        }
+        for (Signed_32 key = 0; key < keys_per_lane; key += 2) {
+          shared_map.erase(key);
+        }
+      }
+      __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    });
+
+    Thread::Worker readers[lane_count];
+    for (Count i = 0; i < lane_count; i++) {
+      readers[i] = Thread::Worker::start("map_reader"_view, []() {
+        while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+          for (Signed_32 key = 0; key < keys_per_lane; key++) {
+            const auto value = shared_map.find_or_default(key, key * 3);
+            if (value != key * 3) {
+              __atomic_fetch_add(&error_count, 1, __ATOMIC_RELAXED);
+            }
+          }
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(error_count, 0);
+  EXPECT_EQ(shared_map.get_size(), keys_per_lane / 2);
+}
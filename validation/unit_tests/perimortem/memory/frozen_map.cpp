@@ -0,0 +1,111 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+#include "perimortem/memory/frozen/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness FrozenMap = {
+  .name = "Frozen::Map"_view,
+};
+
+PERIMORTEM_UNIT_TEST(FrozenMap, integer_keys) {
+  Dynamic::Map<Signed_32, Bits_64> source;
+  for (Signed_32 i = 0; i < 1000; i++) {
+    source.insert(i * 7, Bits_64(i) << 20);
+  }
+
+  Dynamic::Bytes image;
+  Frozen::Map<Signed_32, Bits_64>::freeze(source, image);
+
+  Frozen::Map<Signed_32, Bits_64> frozen(image.get_view());
+  ASSERT(frozen.is_valid());
+  EXPECT_EQ(frozen.get_size(), 1000);
+
+  for (Signed_32 i = 0; i < 7000; i++) {
+    if (i % 7 == 0) {
+      ASSERT(frozen.contains(i));
+      ASSERT_EQ(*frozen.find(i), Bits_64(i / 7) << 20);
+    } else {
+      ASSERT_NOT(frozen.contains(i));
+    }
+  }
+}
+
+PERIMORTEM_UNIT_TEST(FrozenMap, byte_keys) {
+  Dynamic::Map<Dynamic::Bytes, Count> source;
+  source.insert(Dynamic::Bytes("assets/textures/stone.png"_view), 0);
+  source.insert(Dynamic::Bytes("assets/textures/grass.png"_view), 4096);
+  source.insert(Dynamic::Bytes("a"_view), 8192);
+  source.insert(Dynamic::Bytes(""_view), 12288);
+
+  Dynamic::Bytes image;
+  Frozen::Map<View::Bytes, Count>::freeze(source, image);
+
+  // Move the image somewhere else to make sure nothing points back into the
+  // original buffer.
+  Dynamic::Bytes relocated = image.get_view();
+  image.reset();
+
+  Frozen::Map<View::Bytes, Count> frozen(relocated.get_view());
+  ASSERT(frozen.is_valid());
+  EXPECT_EQ(frozen.get_size(), 4);
+  EXPECT_EQ(frozen.find_or_default("assets/textures/stone.png"_view, 1), 0);
+  EXPECT_EQ(frozen.find_or_default("assets/textures/grass.png"_view, 1), 4096);
+  EXPECT_EQ(frozen.find_or_default("a"_view, 1), 8192);
+  EXPECT_EQ(frozen.find_or_default(""_view, 1), 12288);
+  EXPECT_NOT(frozen.contains("assets/textures/dirt.png"_view));
+  EXPECT_NOT(frozen.contains("b"_view));
+}
+
+PERIMORTEM_UNIT_TEST(FrozenMap, empty_map) {
+  Dynamic::Map<Signed_32, Signed_32> source;
+
+  Dynamic::Bytes image;
+  Frozen::Map<Signed_32, Signed_32>::freeze(source, image);
+
+  Frozen::Map<Signed_32, Signed_32> frozen(image.get_view());
+  ASSERT(frozen.is_valid());
+  EXPECT_EQ(frozen.get_size(), 0);
+  EXPECT_NOT(frozen.contains(0));
+}
+
+PERIMORTEM_UNIT_TEST(FrozenMap, rejects_bad_images) {
+  Dynamic::Map<Signed_32, Signed_32> source;
+  source.insert(1, 2);
+
+  Dynamic::Bytes image;
+  Frozen::Map<Signed_32, Signed_32>::freeze(source, image);
+
+  // Wrong value type.
+  Frozen::Map<Signed_32, Bits_64> wrong_type(image.get_view());
+  EXPECT_NOT(wrong_type.is_valid());
+  EXPECT_NOT(wrong_type.contains(1));
+
+  // Truncated image.
+  Frozen::Map<Signed_32, Signed_32> truncated(image.slice(0, 32));
+  EXPECT_NOT(truncated.is_valid());
+  Frozen::Map<Signed_32, Signed_32> missing_keys(
+      image.slice(0, image.get_size() - 1));
+  EXPECT_NOT(missing_keys.is_valid());
+
+  // Corrupted magic.
+  image.get_access()[0] ^= 0xFF;
+  Frozen::Map<Signed_32, Signed_32> corrupted(image.get_view());
+  EXPECT_NOT(corrupted.is_valid());
+
+  // Reopening a good image recovers.
+  image.get_access()[0] ^= 0xFF;
+  EXPECT(corrupted.open(image.get_view()));
+  EXPECT_EQ(corrupted.find_or_default(1, 0), 2);
+}
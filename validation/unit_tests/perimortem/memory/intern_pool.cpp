@@ -0,0 +1,183 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/thread/worker.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/concurrent/intern_pool.hpp"
+#include "perimortem/memory/dynamic/intern_pool.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+using Dynamic::MapVectorization;
+using Dynamic::Symbol;
+
+static Harness InternPool = {
+  .name = "Memory::InternPool"_view,
+};
+
+// Writes `name_<number>` into `buffer`, returning the view.
+static auto make_name(Bits_8 (&buffer)[32], Count number) -> View::Bytes {
+  Bits_8 digits[20];
+  Count digit_count = 0;
+  do {
+    digits[digit_count++] = Bits_8('0' + number % 10);
+    number /= 10;
+  } while (number);
+
+  const auto prefix = "name_"_view;
+  Data::copy(buffer, prefix.get_data(), prefix.get_size());
+  Count size = prefix.get_size();
+  while (digit_count) {
+    buffer[size++] = digits[--digit_count];
+  }
+
+  return View::Bytes(buffer, size);
+}
+
+PERIMORTEM_UNIT_TEST(InternPool, dynamic_symbols) {
+  Dynamic::InternPool<> pool;
+
+  Bits_8 source[] = {'a', 'l', 'p', 'h', 'a'};
+  const auto alpha = pool.intern(View::Bytes(source, 5));
+  const auto beta = pool.intern("beta"_view);
+  const auto empty = pool.intern(""_view);
+
+  EXPECT_EQ(alpha.get_id(), 0);
+  EXPECT_EQ(beta.get_id(), 1);
+  EXPECT_EQ(empty.get_id(), 2);
+  EXPECT(pool.intern("alpha"_view) == alpha);
+  EXPECT(alpha != beta);
+  EXPECT_EQ(pool.get_size(), 3);
+
+  // The pool keeps its own copy of the text.
+  source[0] = 'A';
+  EXPECT(pool.get_view(alpha) == "alpha"_view);
+  EXPECT(pool.get_view(beta) == "beta"_view);
+  EXPECT_EQ(pool.get_view(empty).get_size(), 0);
+
+  EXPECT(pool.find("beta"_view) == beta);
+  EXPECT_NOT(pool.find("gamma"_view).is_valid());
+  EXPECT_NOT(pool.contains("gamma"_view));
+  EXPECT_EQ(pool.get_size(), 3);
+
+  pool.reset();
+  EXPECT_EQ(pool.get_size(), 0);
+  EXPECT_NOT(pool.contains("alpha"_view));
+  EXPECT_EQ(pool.intern("beta"_view).get_id(), 0);
+}
+
+template <MapVectorization vector_mode>
+auto dense_ids(Test::TestResult& result) -> void {
+  Dynamic::InternPool<vector_mode> pool;
+  Bits_8 buffer[32];
+
+  // Enough names to spill the arena over several pages.
+  constexpr Count name_count = 10000;
+  for (Count i = 0; i < name_count; i++) {
+    ASSERT_EQ(pool.intern(make_name(buffer, i)).get_id(), Bits_32(i));
+  }
+
+  for (Count i = 0; i < name_count; i++) {
+    const auto name = make_name(buffer, i);
+    ASSERT_EQ(pool.intern(name).get_id(), Bits_32(i));
+    ASSERT(pool.get_view(Symbol(Bits_32(i))) == name);
+  }
+  EXPECT_EQ(pool.get_size(), name_count);
+}
+
+PERIMORTEM_UNIT_TEST(InternPool, dynamic_dense_ids) {
+  dense_ids<MapVectorization::Scalar>(result);
+  dense_ids<MapVectorization::Full>(result);
+}
+
+PERIMORTEM_UNIT_TEST(InternPool, concurrent_symbols) {
+  Concurrent::InternPool<> pool;
+
+  const auto alpha = pool.intern("alpha"_view);
+  const auto beta = pool.intern("beta"_view);
+  EXPECT_EQ(alpha.get_id(), 0);
+  EXPECT_EQ(beta.get_id(), 1);
+  EXPECT(pool.intern("alpha"_view) == alpha);
+  EXPECT(pool.find("beta"_view) == beta);
+  EXPECT_NOT(pool.find("gamma"_view).is_valid());
+  EXPECT(pool.get_view(alpha) == "alpha"_view);
+  EXPECT_EQ(pool.get_size(), 2);
+
+  // Crossing into later chunks of the id table.
+  Bits_8 buffer[32];
+  for (Count i = 0; i < 5000; i++) {
+    pool.intern(make_name(buffer, i));
+  }
+  EXPECT_EQ(pool.get_size(), 5002);
+  EXPECT(pool.get_view(pool.find(make_name(buffer, 4321))) ==
+         make_name(buffer, 4321));
+}
+
+// Shared state for the threaded test since worker jobs don't take arguments.
+static constexpr Count lane_count = 4;
+static constexpr Count shared_names = 2048;
+static Concurrent::InternPool<>* shared_pool = nullptr;
+static Count error_count = 0;
+static Count finished_count = 0;
+static Bits_32 pool_released = 0;
+
+// Kept out of the test body so a failed ASSERT still releases the workers.
+auto check_shared_pool(Test::TestResult& result) -> void {
+  EXPECT_EQ(error_count, 0);
+  ASSERT_EQ(shared_pool->get_size(), shared_names);
+
+  // Ids are dense and each one maps back to a distinct name.
+  static Bool seen[shared_names];
+  Bits_8 buffer[32];
+  for (Count n = 0; n < shared_names; n++) {
+    const auto symbol = shared_pool->find(make_name(buffer, n));
+    ASSERT(symbol.is_valid());
+    ASSERT(symbol.get_id() < shared_names);
+    EXPECT_NOT(seen[symbol.get_id()]);
+    seen[symbol.get_id()] = true;
+  }
+}
+
+PERIMORTEM_UNIT_TEST(InternPool, concurrent_threaded) {
+  error_count = 0;
+  finished_count = 0;
+  pool_released = 0;
+
+  // Memory the workers take while interning comes from their own Bibliotheca,
+  // so they wait for the pool to be destroyed before exiting.
+  Thread::Worker workers[lane_count];
+  {
+    Concurrent::InternPool<> pool;
+    shared_pool = &pool;
+
+    // Every worker interns the same names so they race to add each one.
+    for (Count i = 0; i < lane_count; i++) {
+      workers[i] = Thread::Worker::start("interner"_view, []() {
+        Bits_8 buffer[32];
+        for (Count n = 0; n < shared_names; n++) {
+          const auto name = make_name(buffer, n);
+          const auto symbol = shared_pool->intern(name);
+          if (!(shared_pool->get_view(symbol) == name)) {
+            __atomic_fetch_add(&error_count, 1, __ATOMIC_RELAXED);
+          }
+        }
+
+        __atomic_fetch_add(&finished_count, 1, __ATOMIC_RELEASE);
+        while (!__atomic_load_n(&pool_released, __ATOMIC_ACQUIRE)) {
+        }
+      });
+    }
+
+    while (__atomic_load_n(&finished_count, __ATOMIC_ACQUIRE) < lane_count) {
+    }
+    check_shared_pool(result);
+  }
+
+  __atomic_store_n(&pool_released, 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,99 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/algorithm/unicode.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/line_index.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness LineIndex = {
+  .name = "Dynamic::LineIndex"_view,
+};
+
+PERIMORTEM_UNIT_TEST(LineIndex, ascii) {
+  Dynamic::LineIndex index("one\ntwo\r\n\nthree"_view);
+  EXPECT_EQ(index.get_line_count(), 4);
+  EXPECT_EQ(index.get_line_start(1), 4);
+  EXPECT_EQ(index.get_line_start(2), 9);
+  EXPECT_EQ(index.get_line_start(3), 10);
+  EXPECT_EQ(index.get_line_start(4), 15);
+
+  const auto position = index.get_position(12);
+  EXPECT_EQ(position.line, 3);
+  EXPECT_EQ(position.column, 2);
+  EXPECT_EQ(index.get_offset({.line = 3, .column = 2}), 12);
+
+  // The '\r' belongs to its line, long columns stop at the newline.
+  EXPECT_EQ(index.get_position(7).column, 3);
+  EXPECT_EQ(index.get_offset({.line = 1, .column = 100}), 8);
+  EXPECT_EQ(index.get_offset({.line = 3, .column = 100}), 15);
+  EXPECT_EQ(index.get_offset({.line = 9, .column = 0}), 15);
+}
+
+PERIMORTEM_UNIT_TEST(LineIndex, utf16_columns) {
+  // "é" is one unit, "😀" is a surrogate pair.
+  Dynamic::LineIndex index("x\ncaf\xC3\xA9 \xF0\x9F\x98\x80!"_view);
+
+  EXPECT_EQ(index.get_position(7).column, 4);
+  EXPECT_EQ(index.get_position(8).column, 5);
+  EXPECT_EQ(index.get_position(12).column, 7);
+
+  EXPECT_EQ(index.get_offset({.line = 1, .column = 4}), 7);
+  EXPECT_EQ(index.get_offset({.line = 1, .column = 5}), 8);
+  EXPECT_EQ(index.get_offset({.line = 1, .column = 7}), 12);
+
+  // Between the halves of the pair snaps back to the start of the emoji.
+  EXPECT_EQ(index.get_offset({.line = 1, .column = 6}), 8);
+}
+
+PERIMORTEM_UNIT_TEST(LineIndex, round_trip) {
+  // Long enough to cover many blocks, with code points straddling the block
+  // boundaries.
+  const View::Bytes pieces[] = {
+      "ab"_view, "\n"_view, "\xC3\xA9"_view, "\xE2\x82\xAC"_view,
+      "\xF0\x9F\x98\x80"_view, "\r\n"_view,
+  };
+
+  Dynamic::Bytes text;
+  Bits_64 state = 0x9E3779B97F4A7C15;
+  while (text.get_size() < 5000) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    text.concat(pieces[state % 6]);
+  }
+
+  Dynamic::LineIndex index(text.get_view());
+  Count line = 0;
+  Count line_start = 0;
+  for (Count i = 0; i <= text.get_size(); i++) {
+    // Only check offsets at the start of a code point.
+    if (i < text.get_size() && (text[i] & 0xC0) == 0x80) {
+      continue;
+    }
+
+    const auto position = index.get_position(i);
+    ASSERT_EQ(position.line, line);
+    ASSERT_EQ(position.column,
+              Algorithm::utf16_length(text.slice(line_start, i - line_start)));
+    ASSERT_EQ(index.get_offset(position), i);
+    ASSERT_EQ(index.from_utf16(index.to_utf16(i)), i);
+
+    if (i < text.get_size() && text[i] == '\n') {
+      line++;
+      line_start = i + 1;
+    }
+  }
+
+  EXPECT_EQ(index.get_line_count(), line + 1);
+  EXPECT_EQ(index.to_utf16(text.get_size()),
+            Algorithm::utf16_length(text.get_view()));
+}
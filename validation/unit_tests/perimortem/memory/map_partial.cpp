@@ -258,6 +258,294 @@ PERIMORTEM_UNIT_TEST(DynamicMapPartial, reuse) {
   }
 }
 
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, erase) {
+  Dynamic::Map<Signed_32, Signed_32, vector_mode> int_map = {
+    {{1, 2}, {2, 3}, {4, 5}}};
+
+  EXPECT(int_map.erase(2));
+  EXPECT_NOT(int_map.erase(2));
+  EXPECT_NOT(int_map.erase(7));
+
+  EXPECT_EQ(int_map.get_size(), 2);
+  EXPECT_NOT(int_map.contains(2));
+  EXPECT_EQ(int_map[1], 2);
+  EXPECT_EQ(int_map[4], 5);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, erase_stress_test) {
+  Dynamic::Map<Signed_32, Signed_32, vector_mode> large_map;
+
+  // Run the table close to its load limit so erasing has to repair overflow
+  // chains between buckets.
+  for (Count i = 0; i < 2000; i++) {
+    large_map.insert(i, i + 2);
+  }
+
+  for (Count i = 0; i < 2000; i += 3) {
+    ASSERT(large_map.erase(i));
+  }
+
+  for (Count i = 0; i < 2000; i++) {
+    if (i % 3 == 0) {
+      ASSERT_NOT(large_map.contains(i));
+    } else {
+      ASSERT_EQ(large_map[i], i + 2);
+    }
+  }
+
+  // Refill the erased keys and then drain the table completely.
+  for (Count i = 0; i < 2000; i += 3) {
+    large_map.insert(i, i + 4);
+  }
+  EXPECT_EQ(large_map.get_size(), 2000);
+
+  for (Count i = 0; i < 2000; i++) {
+    ASSERT(large_map.erase(i));
+    ASSERT_NOT(large_map.contains(i));
+  }
+  EXPECT_EQ(large_map.get_size(), 0);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, erase_construction_count) {
+  Count construct_count = 0;
+  Count destruct_count = 0;
+
+  {
+    Dynamic::Map<Hashable, Signed_32, vector_mode> custom_map;
+
+    for (Count i = 0; i < 100; i++) {
+      custom_map.insert(Hashable(i, construct_count, destruct_count), i);
+    }
+
+    for (Count i = 0; i < 100; i += 2) {
+      custom_map.erase(Hashable(i, construct_count, destruct_count));
+    }
+
+    // Erasing destroys the stored key, moving entries shouldn't construct.
+    EXPECT_EQ(custom_map.get_size(), 50);
+    EXPECT_EQ(construct_count, 250);
+    EXPECT_EQ(destruct_count, 200);
+  }
+
+  EXPECT_EQ(construct_count, destruct_count);
+  EXPECT_EQ(default_construct_count, 0);
+  EXPECT_EQ(default_destruct_count, 0);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, iteration) {
+  Dynamic::Map<Signed_32, Signed_32, vector_mode> large_map;
+
+  Count visited = 0;
+  for (auto& entry : large_map) {
+    visited += entry.value;
+  }
+  EXPECT_EQ(visited, 0);
+
+  for (Count i = 0; i < 1000; i++) {
+    large_map.insert(i, 1);
+  }
+
+  for (Count i = 0; i < 1000; i += 2) {
+    large_map.erase(i);
+  }
+
+  // Every remaining entry should be visited exactly once.
+  Count key_sum = 0;
+  for (auto& entry : large_map) {
+    visited += entry.value;
+    key_sum += entry.key;
+    entry.value = 2;
+  }
+
+  EXPECT_EQ(visited, 500);
+  EXPECT_EQ(key_sum, 250000);
+  for (Count i = 1; i < 1000; i += 2) {
+    ASSERT_EQ(large_map[i], 2);
+  }
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, batched_lookups) {
+  using IntMap = Dynamic::Map<Signed_32, Signed_32, vector_mode>;
+  IntMap large_map;
+
+  static Signed_32 queries[1001];
+  static IntMap::Entry* entries[1001];
+  static Bool found[1001];
+  for (Count i = 0; i < 1001; i++) {
+    queries[i] = Signed_32(i * 3);
+  }
+
+  // Batches against an empty map should resolve without touching buckets.
+  large_map.contains_batch(
+      View::Vector<Signed_32>(queries), Access::Vector<Bool>(found));
+  for (Count i = 0; i < 1001; i++) {
+    ASSERT_NOT(found[i]);
+  }
+
+  for (Count i = 0; i < 1000; i++) {
+    large_map.insert(i, i + 2);
+  }
+
+  // Use an odd number of keys so the last group is partial.
+  large_map.find_batch(
+      View::Vector<Signed_32>(queries),
+      Access::Vector<IntMap::Entry*>(entries));
+  large_map.contains_batch(
+      View::Vector<Signed_32>(queries), Access::Vector<Bool>(found));
+
+  for (Count i = 0; i < 1001; i++) {
+    if (queries[i] < 1000) {
+      ASSERT(found[i]);
+      ASSERT(entries[i] != nullptr);
+      ASSERT_EQ(entries[i]->key, queries[i]);
+      ASSERT_EQ(entries[i]->value, queries[i] + 2);
+    } else {
+      ASSERT_NOT(found[i]);
+      ASSERT(entries[i] == nullptr);
+    }
+  }
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, overwrite_keeps_capacity) {
+  // Find how many keys fit before the table has to grow.
+  Count limit = 0;
+  {
+    Dynamic::Map<Signed_32, Signed_32, vector_mode> probe_map;
+    probe_map.insert(0, 0);
+    const auto capacity = probe_map.get_memory_consumption();
+    while (probe_map.get_memory_consumption() == capacity) {
+      limit++;
+      probe_map.insert(limit, limit);
+    }
+  }
+
+  Dynamic::Map<Signed_32, Signed_32, vector_mode> full_map;
+  for (Count i = 0; i < limit; i++) {
+    full_map.insert(i, i);
+  }
+  const auto capacity = full_map.get_memory_consumption();
+
+  // Overwriting existing keys shouldn't grow a table at its load limit.
+  full_map.insert(0, 5);
+  full_map[1] = 6;
+  EXPECT_EQ(full_map.get_memory_consumption(), capacity);
+  EXPECT_EQ(full_map[0], 5);
+  EXPECT_EQ(full_map[1], 6);
+
+  full_map.insert(limit, 7);
+  EXPECT_NOT(full_map.get_memory_consumption() == capacity);
+  EXPECT_EQ(full_map[limit], 7);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, incremental_growth) {
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+
+  {
+    // Move at most 2 buckets per operation.
+    Dynamic::Map<Signed_32, Signed_32, vector_mode, 2> incremental_map;
+
+    Bool migrated = false;
+    for (Count i = 0; i < 5000; i++) {
+      incremental_map.insert(i, i + 2);
+      migrated |= incremental_map.is_migrating();
+
+      // Keys in both tables should resolve while the move is in flight.
+      ASSERT(incremental_map.contains(i / 2));
+    }
+    EXPECT(migrated);
+    EXPECT_EQ(incremental_map.get_size(), 5000);
+
+    // Overwrite and erase keys regardless of which table they're in.
+    for (Count i = 0; i < 5000; i += 2) {
+      incremental_map[i] = i + 4;
+      ASSERT(incremental_map.erase(i + 1));
+    }
+
+    Count visited = 0;
+    for (auto& entry : incremental_map) {
+      ASSERT_EQ(entry.key % 2, 0);
+      ASSERT_EQ(entry.value, entry.key + 4);
+      visited++;
+    }
+    EXPECT_EQ(visited, 2500);
+    EXPECT_EQ(incremental_map.get_size(), 2500);
+  }
+
+  auto post_test_memory = Bibliotheca::allocated_memory();
+  EXPECT_EQ(pre_test_memory, post_test_memory);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, erase_while_migrating) {
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+
+  {
+    Dynamic::Map<Signed_32, Signed_32, vector_mode, 2> incremental_map;
+    // Stop right as a move out of a table with plenty of buckets starts.
+    Signed_32 inserted = 0;
+    while (incremental_map.get_size() < 1000 ||
+           !incremental_map.is_migrating() ||
+           incremental_map.get_migration_cursor() != 0) {
+      incremental_map.insert(inserted, inserted + 2);
+      inserted++;
+    }
+
+    // Keys still in the previous table, including ones in its last buckets,
+    // are erased without moving more than the limit of buckets.
+    Signed_32 erased = inserted;
+    while (incremental_map.is_migrating() && erased > 0) {
+      const Count cursor = incremental_map.get_migration_cursor();
+      erased--;
+      ASSERT(incremental_map.erase(erased));
+      if (incremental_map.is_migrating()) {
+        ASSERT(incremental_map.get_migration_cursor() - cursor <= 2);
+      }
+    }
+    EXPECT(erased < inserted);
+
+    for (Signed_32 i = 0; i < erased; i++) {
+      ASSERT(incremental_map.contains(i));
+    }
+    for (Signed_32 i = erased; i < inserted; i++) {
+      EXPECT_NOT(incremental_map.contains(i));
+    }
+    EXPECT_EQ(incremental_map.get_size(), Count(erased));
+  }
+
+  auto post_test_memory = Bibliotheca::allocated_memory();
+  EXPECT_EQ(pre_test_memory, post_test_memory);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapPartial, heterogeneous_lookup) {
+  Dynamic::Map<Dynamic::Bytes, Signed_32, vector_mode> text_map;
+  text_map.insert(Dynamic::Bytes("Hello"_view), 1);
+  text_map.insert(Dynamic::Bytes("Longer test string"_view), 2);
+
+  // Probing with views shouldn't build any temporary keys.
+  auto pre_lookup_memory = Bibliotheca::allocated_memory();
+  EXPECT(text_map.contains("Hello"_view));
+  EXPECT_NOT(text_map.contains("World"_view));
+  EXPECT_EQ(text_map.find_or_default("Longer test string"_view, 0), 2);
+  EXPECT_EQ(text_map.at("Hello"_view), 1);
+  EXPECT(text_map.find("Missing"_view) == nullptr);
+  EXPECT_EQ(pre_lookup_memory, Bibliotheca::allocated_memory());
+
+  // Missing keys are only converted once they're inserted.
+  text_map.at("World"_view) = 3;
+  EXPECT_EQ(text_map.get_size(), 3);
+  EXPECT_EQ(text_map[Dynamic::Bytes("World"_view)], 3);
+
+  EXPECT(text_map.erase("Hello"_view));
+  EXPECT_NOT(text_map.contains(Dynamic::Bytes("Hello"_view)));
+
+  // Integer lookups are converted to the key type before hashing.
+  Dynamic::Map<Signed_64, Signed_32, vector_mode> int_map;
+  int_map.insert(-1, 1);
+  int_map.insert(1ll << 40, 2);
+  EXPECT_EQ(int_map.find_or_default(Signed_32(-1), 0), 1);
+  EXPECT_EQ(int_map.find_or_default(Count(1) << 40, 0), 2);
+  EXPECT_NOT(int_map.contains(Bits_8(1)));
+}
+
 PERIMORTEM_UNIT_TEST(DynamicMapPartial, leak_test) {
   auto pre_test_memory = Bibliotheca::allocated_memory();
 
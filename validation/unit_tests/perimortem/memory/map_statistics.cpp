@@ -0,0 +1,140 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+using Dynamic::MapStatistics;
+using Dynamic::MapStorage;
+using Dynamic::MapVectorization;
+
+static Harness DynamicMapStatistics = {
+  .name = "Dynamic::Map Statistics"_view,
+};
+
+// Helpers take the test result so they can use the test macros.
+auto check_layout(Test::TestResult& result, const MapStatistics& stats)
+    -> void {
+  // The histogram has to cover every bucket and every entry exactly once.
+  Count buckets = 0;
+  Count entries = 0;
+  for (Count i = 0; i < 65; i++) {
+    buckets += stats.occupancy[i];
+    entries += stats.occupancy[i] * i;
+  }
+
+  EXPECT_EQ(buckets, stats.bucket_count);
+  EXPECT_EQ(entries, stats.entries);
+  EXPECT(stats.max_probe_distance < stats.bucket_count);
+  EXPECT(stats.average_probe_distance() <= Real_64(stats.max_probe_distance));
+}
+
+template <MapVectorization vector_mode>
+auto layout_statistics(Test::TestResult& result) -> void {
+  Dynamic::Map<Signed_32, Signed_32, vector_mode> int_map;
+  for (Signed_32 i = 0; i < 1000; i++) {
+    int_map.insert(i, i);
+  }
+
+  const auto stats = int_map.get_statistics();
+  ASSERT_EQ(stats.entries, 1000);
+  EXPECT(int_map.get_capacity() >= stats.entries);
+  check_layout(result, stats);
+
+  // Maps that aren't instrumented don't count anything.
+  EXPECT_EQ(stats.tag_matches, 0);
+  EXPECT_EQ(stats.false_positives, 0);
+  EXPECT_EQ(stats.growth_events, 0);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStatistics, layout) {
+  layout_statistics<MapVectorization::Scalar>(result);
+  layout_statistics<MapVectorization::Partial>(result);
+  layout_statistics<MapVectorization::Full>(result);
+  layout_statistics<MapVectorization::Wide>(result);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStatistics, empty_map) {
+  Dynamic::Map<Signed_32, Signed_32> int_map;
+  const auto stats = int_map.get_statistics();
+
+  EXPECT_EQ(stats.bucket_count, 0);
+  EXPECT_EQ(stats.entries, 0);
+  EXPECT_EQ(stats.max_probe_distance, 0);
+  EXPECT(stats.average_probe_distance() == 0.0);
+  EXPECT(stats.false_positive_rate() == 0.0);
+}
+
+template <MapVectorization vector_mode>
+auto instrumented_statistics(Test::TestResult& result) -> void {
+  using InstrumentedMap = Dynamic::
+      Map<Signed_32, Signed_32, vector_mode, 0, MapStorage::Bibliotheca, true>;
+  InstrumentedMap int_map;
+
+  // Starting empty forces the table through a few growths.
+  for (Signed_32 i = 0; i < 1000; i++) {
+    int_map.insert(i, i);
+  }
+
+  auto stats = int_map.get_statistics();
+  ASSERT_EQ(stats.entries, 1000);
+  check_layout(result, stats);
+  EXPECT(stats.growth_events > 1);
+  EXPECT(stats.false_positives <= stats.tag_matches);
+
+  // Every hit has to match at least the tag of its own slot.
+  const auto matches_before = stats.tag_matches;
+  for (Signed_32 i = 0; i < 1000; i++) {
+    ASSERT_EQ(int_map.find_or_default(i, -1), i);
+  }
+
+  stats = int_map.get_statistics();
+  EXPECT(stats.tag_matches >= matches_before + 1000);
+  EXPECT(stats.false_positives <= stats.tag_matches);
+  EXPECT(stats.false_positive_rate() >= 0.0);
+  EXPECT(stats.false_positive_rate() <= 1.0);
+
+  // Reserving up front means nothing grows after the first table.
+  InstrumentedMap reserved(1000);
+  for (Signed_32 i = 0; i < 1000; i++) {
+    reserved.insert(i, i);
+  }
+  EXPECT_EQ(reserved.get_statistics().growth_events, 1);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStatistics, instrumented) {
+  instrumented_statistics<MapVectorization::Scalar>(result);
+  instrumented_statistics<MapVectorization::Partial>(result);
+  instrumented_statistics<MapVectorization::Full>(result);
+  instrumented_statistics<MapVectorization::Wide>(result);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStatistics, instrumented_text_keys) {
+  Dynamic::Map<
+      View::Bytes,
+      Signed_32,
+      MapVectorization::Scalar,
+      0,
+      MapStorage::Bibliotheca,
+      true>
+      text_map;
+  text_map.insert("alpha"_view, 1);
+  text_map.insert("beta"_view, 2);
+  text_map.insert("gamma"_view, 3);
+
+  EXPECT_EQ(text_map.find_or_default("beta"_view, -1), 2);
+  EXPECT_EQ(text_map.find_or_default("delta"_view, -1), -1);
+
+  const auto stats = text_map.get_statistics();
+  EXPECT_EQ(stats.entries, 3);
+  EXPECT(stats.tag_matches >= 1);
+  check_layout(result, stats);
+}
@@ -0,0 +1,169 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/allocator/arena.hpp"
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+using Dynamic::MapStorage;
+using Dynamic::MapVectorization;
+
+static Harness DynamicMapStorage = {
+  .name = "Dynamic::Map Storage"_view,
+};
+
+// Helpers take the test result so they can use the test macros.
+template <MapVectorization vector_mode>
+auto arena_round_trip(Test::TestResult& result) -> void {
+  Allocator::Arena arena;
+  using ArenaMap =
+      Dynamic::Map<Signed_32, Signed_32, vector_mode, 0, MapStorage::Arena>;
+  ArenaMap int_map(arena);
+
+  for (Signed_32 i = 0; i < 1000; i++) {
+    int_map.insert(i, i * 2);
+  }
+
+  ASSERT_EQ(int_map.get_size(), 1000);
+  for (Signed_32 i = 0; i < 1000; i++) {
+    ASSERT_EQ(int_map.find_or_default(i, -1), i * 2);
+  }
+
+  EXPECT(int_map.erase(10));
+  EXPECT_NOT(int_map.contains(10));
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStorage, arena_storage) {
+  arena_round_trip<MapVectorization::Scalar>(result);
+  arena_round_trip<MapVectorization::Partial>(result);
+  arena_round_trip<MapVectorization::Full>(result);
+  arena_round_trip<MapVectorization::Wide>(result);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStorage, arena_drop_is_free) {
+  Allocator::Arena arena;
+
+  auto pre_map_memory = Bibliotheca::allocated_memory();
+  {
+    using ArenaMap = Dynamic::Map<
+        Signed_32,
+        Signed_32,
+        MapVectorization::Full,
+        0,
+        MapStorage::Arena>;
+
+    ArenaMap int_map(arena, 100);
+    for (Signed_32 i = 0; i < 100; i++) {
+      int_map.insert(i, i);
+    }
+  }
+
+  // The table lives in the arena's first page so the map never touches the
+  // Bibliotheca.
+  EXPECT_EQ(pre_map_memory, Bibliotheca::allocated_memory());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStorage, arena_copy_and_move) {
+  Allocator::Arena arena;
+  using ArenaMap = Dynamic::Map<
+      Signed_32,
+      Signed_32,
+      MapVectorization::Partial,
+      0,
+      MapStorage::Arena>;
+
+  ArenaMap source(arena);
+  for (Signed_32 i = 0; i < 100; i++) {
+    source.insert(i, i + 1);
+  }
+
+  auto copy = source;
+  auto moved = Data::take(source);
+  EXPECT_EQ(source.get_size(), 0);
+  EXPECT_EQ(copy.get_size(), 100);
+  EXPECT_EQ(moved.get_size(), 100);
+
+  // The moved from map can still be used with the same arena.
+  source.insert(7, 7);
+  EXPECT_EQ(source.find_or_default(7, 0), 7);
+  EXPECT_EQ(copy.find_or_default(7, 0), 8);
+  EXPECT_EQ(moved.find_or_default(99, 0), 100);
+}
+
+template <MapVectorization vector_mode>
+auto inline_round_trip(Test::TestResult& result) -> void {
+  using InlineMap =
+      Dynamic::Map<Signed_32, Signed_32, vector_mode, 0, MapStorage::Inline>;
+
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+  {
+    InlineMap int_map;
+    for (Signed_32 i = 0; i < 16; i++) {
+      int_map.insert(i, i * 3);
+    }
+
+    // Small tables never allocate.
+    ASSERT_EQ(pre_test_memory, Bibliotheca::allocated_memory());
+    ASSERT_EQ(int_map.get_size(), 16);
+
+    // Larger tables spill over to the Bibliotheca.
+    for (Signed_32 i = 16; i < 500; i++) {
+      int_map.insert(i, i * 3);
+    }
+    ASSERT_NOT(pre_test_memory == Bibliotheca::allocated_memory());
+    for (Signed_32 i = 0; i < 500; i++) {
+      ASSERT_EQ(int_map.find_or_default(i, -1), i * 3);
+    }
+  }
+
+  EXPECT_EQ(pre_test_memory, Bibliotheca::allocated_memory());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStorage, inline_storage) {
+  inline_round_trip<MapVectorization::Scalar>(result);
+  inline_round_trip<MapVectorization::Partial>(result);
+  inline_round_trip<MapVectorization::Full>(result);
+  inline_round_trip<MapVectorization::Wide>(result);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicMapStorage, inline_copy_and_move) {
+  using InlineMap = Dynamic::Map<
+      Signed_32,
+      Dynamic::Bytes,
+      MapVectorization::Scalar,
+      0,
+      MapStorage::Inline>;
+
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+  {
+    InlineMap source;
+    source[1] = "Hello"_view;
+    source[2] = "World"_view;
+
+    InlineMap copy = source;
+    InlineMap moved = Data::take(source);
+    EXPECT_EQ(source.get_size(), 0);
+    EXPECT_NOT(source.contains(1));
+
+    ASSERT_EQ(moved.get_size(), 2);
+    ASSERT_TEXT(moved[1].get_view(), "Hello"_view);
+    ASSERT_TEXT(moved[2].get_view(), "World"_view);
+    ASSERT_TEXT(copy[2].get_view(), "World"_view);
+
+    // Reuse the moved from map.
+    source[3] = "Again"_view;
+    ASSERT_TEXT(source[3].get_view(), "Again"_view);
+  }
+
+  EXPECT_EQ(pre_test_memory, Bibliotheca::allocated_memory());
+}
@@ -0,0 +1,204 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/piece_table.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness PieceTable = {
+  .name = "Dynamic::PieceTable"_view,
+};
+
+static auto flatten(const Dynamic::PieceTable& table) -> Dynamic::Bytes {
+  Dynamic::Bytes output;
+  table.copy(0, table.get_size(), output);
+  return output;
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, edits) {
+  Dynamic::PieceTable table("hello world"_view);
+  EXPECT_EQ(table.get_size(), 11);
+  EXPECT_EQ(table.get_piece_count(), 1);
+
+  table.insert(5, ","_view);
+  EXPECT(flatten(table) == "hello, world"_view);
+
+  table.insert(12, "!"_view);
+  table.insert(0, "> "_view);
+  EXPECT(flatten(table) == "> hello, world!"_view);
+
+  table.erase(0, 2);
+  table.replace(7, 5, "there"_view);
+  EXPECT(flatten(table) == "hello, there!"_view);
+
+  // Out of range edits clamp to the end.
+  table.insert(1000, "?"_view);
+  table.erase(12, 1000);
+  EXPECT(flatten(table) == "hello, there"_view);
+
+  table.erase(0, table.get_size());
+  EXPECT_EQ(table.get_size(), 0);
+  EXPECT_EQ(table.get_piece_count(), 0);
+
+  table.reset("fresh"_view);
+  EXPECT(flatten(table) == "fresh"_view);
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, typing_extends_piece) {
+  Dynamic::PieceTable table("ab"_view);
+
+  const auto text = "the quick brown fox"_view;
+  for (Count i = 0; i < text.get_size(); i++) {
+    table.insert(1 + i, text.slice(i, 1));
+  }
+
+  EXPECT(flatten(table) == "athe quick brown foxb"_view);
+  EXPECT_EQ(table.get_piece_count(), 3);
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, visit_chunks) {
+  Dynamic::PieceTable table("0123456789"_view);
+  table.insert(5, "abc"_view);
+
+  // The range covers the tail of one piece, all of the insert and the head of
+  // the next, so it arrives as three chunks.
+  Count chunks = 0;
+  Dynamic::Bytes output;
+  table.visit(3, 7, [&](View::Bytes chunk) {
+    chunks++;
+    output.concat(chunk);
+  });
+
+  EXPECT_EQ(chunks, 3);
+  EXPECT(output == "34abc56"_view);
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, line_index) {
+  Dynamic::PieceTable table("one\ntwo\nthree"_view);
+  EXPECT_EQ(table.get_line_count(), 3);
+  EXPECT_EQ(table.get_line_start(0), 0);
+  EXPECT_EQ(table.get_line_start(1), 4);
+  EXPECT_EQ(table.get_line_start(2), 8);
+  EXPECT_EQ(table.get_line_start(3), table.get_size());
+  EXPECT_EQ(table.get_line(0), 0);
+  EXPECT_EQ(table.get_line(3), 0);
+  EXPECT_EQ(table.get_line(4), 1);
+  EXPECT_EQ(table.get_line(12), 2);
+
+  table.insert(4, "1.5\n"_view);
+  EXPECT_EQ(table.get_line_count(), 4);
+  EXPECT_EQ(table.get_line_start(2), 8);
+  EXPECT_EQ(table.get_line(9), 2);
+
+  // Joining lines by dropping a newline.
+  table.erase(3, 1);
+  EXPECT_EQ(table.get_line_count(), 3);
+  EXPECT_EQ(table.get_line_start(1), 7);
+  EXPECT(flatten(table) == "one1.5\ntwo\nthree"_view);
+}
+
+// Xorshift so the edits are the same every run.
+static auto next_random(Bits_64& state) -> Bits_64 {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, matches_flat_buffer) {
+  const auto alphabet = "abcdefgh\n"_view;
+  Bits_8 text[16];
+
+  Dynamic::PieceTable table("seed\ntext\n"_view);
+  Dynamic::Bytes expected("seed\ntext\n"_view);
+  Bits_64 state = 0x2545F4914F6CDD1D;
+
+  for (Count round = 0; round < 2000; round++) {
+    const Count size = expected.get_size();
+    const Count offset = next_random(state) % (size + 1);
+
+    if (next_random(state) % 3 == 0) {
+      const Count erase_size = next_random(state) % 12;
+      table.erase(offset, erase_size);
+
+      const Count removed = Math::min(erase_size, size - offset);
+      Dynamic::Bytes rebuilt(expected.slice(0, offset));
+      rebuilt.concat(
+          expected.slice(offset + removed, size - offset - removed));
+      expected = static_cast<Dynamic::Bytes&&>(rebuilt);
+    } else {
+      const Count text_size = 1 + next_random(state) % 15;
+      for (Count i = 0; i < text_size; i++) {
+        text[i] = alphabet[next_random(state) % alphabet.get_size()];
+      }
+
+      table.insert(offset, View::Bytes(text, text_size));
+
+      Dynamic::Bytes rebuilt(expected.slice(0, offset));
+      rebuilt.concat(View::Bytes(text, text_size));
+      rebuilt.concat(expected.slice(offset, size - offset));
+      expected = static_cast<Dynamic::Bytes&&>(rebuilt);
+    }
+
+    ASSERT_EQ(table.get_size(), expected.get_size());
+  }
+
+  ASSERT(flatten(table) == expected);
+
+  // Check the line index against a scan of the flat copy.
+  Count line = 0;
+  for (Count i = 0; i < expected.get_size(); i++) {
+    ASSERT_EQ(table.get_line(i), line);
+    if (expected[i] == '\n') {
+      line++;
+      ASSERT_EQ(table.get_line_start(line), i + 1);
+    }
+  }
+  EXPECT_EQ(table.get_line_count(), line + 1);
+
+  // Random ranges come back intact too.
+  for (Count round = 0; round < 200; round++) {
+    const Count offset = next_random(state) % (expected.get_size() + 1);
+    const Count size =
+        next_random(state) % (expected.get_size() - offset + 1);
+
+    Dynamic::Bytes range;
+    table.copy(offset, size, range);
+    ASSERT(range == expected.slice(offset, size));
+  }
+}
+
+PERIMORTEM_UNIT_TEST(PieceTable, middle_inserts_stay_balanced) {
+  Dynamic::PieceTable table("[]"_view);
+  Dynamic::Bytes expected("[]"_view);
+
+  // Each insert lands inside the piece added by the one before, so every one
+  // cuts a piece in two.
+  for (Count round = 0; round < 20000; round++) {
+    const Count offset = table.get_size() / 2;
+    const Bits_8 text[] = {Bits_8('a' + round % 26), '\n'};
+    table.insert(offset, View::Bytes(text, 2));
+
+    Dynamic::Bytes rebuilt(expected.slice(0, offset));
+    rebuilt.concat(View::Bytes(text, 2));
+    rebuilt.concat(expected.slice(offset, expected.get_size() - offset));
+    expected = static_cast<Dynamic::Bytes&&>(rebuilt);
+  }
+
+  // Every insert adds its own piece plus the tail of the one it cut.
+  EXPECT_EQ(table.get_piece_count(), 40001);
+  ASSERT(flatten(table) == expected);
+  EXPECT_EQ(table.get_line_count(), 20001);
+
+  // A treap over ~40k pieces sits around 40 deep, leave plenty of slack while
+  // still catching a tree that degrades into a list.
+  EXPECT(table.get_depth() < 100);
+}
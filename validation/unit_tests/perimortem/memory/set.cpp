@@ -0,0 +1,150 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/dynamic/map.hpp"
+#include "perimortem/memory/dynamic/set.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+using Dynamic::MapVectorization;
+
+static Harness DynamicSet = {
+  .name = "Dynamic::Set"_view,
+};
+
+PERIMORTEM_UNIT_TEST(DynamicSet, insert_and_erase) {
+  Dynamic::Set<Signed_32> int_set;
+
+  EXPECT_EQ(int_set.get_size(), 0);
+  EXPECT(int_set.insert(1));
+  EXPECT_NOT(int_set.insert(1));
+  EXPECT(int_set.insert(2));
+  EXPECT_EQ(int_set.get_size(), 2);
+
+  EXPECT(int_set.contains(1));
+  EXPECT_NOT(int_set.contains(3));
+
+  EXPECT(int_set.erase(1));
+  EXPECT_NOT(int_set.erase(1));
+  EXPECT_NOT(int_set.contains(1));
+  EXPECT_EQ(int_set.get_size(), 1);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicSet, byte_keys) {
+  Dynamic::Set<Dynamic::Bytes> text_set;
+  text_set.insert("Hello"_view);
+  text_set.insert("World"_view);
+  text_set.insert("Hello"_view);
+
+  EXPECT_EQ(text_set.get_size(), 2);
+  EXPECT(text_set.contains("Hello"_view));
+  EXPECT_NOT(text_set.contains("Missing"_view));
+}
+
+PERIMORTEM_UNIT_TEST(DynamicSet, iteration) {
+  Dynamic::Set<Signed_32, MapVectorization::Full> int_set;
+  for (Signed_32 i = 0; i < 500; i++) {
+    int_set.insert(i * 3);
+  }
+
+  Count seen = 0;
+  Signed_64 sum = 0;
+  for (const auto& key : int_set) {
+    seen++;
+    sum += key;
+  }
+
+  EXPECT_EQ(seen, 500);
+  EXPECT_EQ(sum, 3 * (499 * 500 / 2));
+}
+
+// Helpers take the test result so they can use the test macros.
+template <MapVectorization vector_mode>
+auto bulk_operations(Test::TestResult& result) -> void {
+  using IntSet = Dynamic::Set<Signed_32, vector_mode>;
+
+  // Multiples of 2 and 3 below 3000 overlap on multiples of 6.
+  IntSet twos;
+  IntSet threes;
+  for (Signed_32 i = 0; i < 3000; i++) {
+    if (i % 2 == 0) {
+      twos.insert(i);
+    }
+    if (i % 3 == 0) {
+      threes.insert(i);
+    }
+  }
+
+  const auto either = IntSet::unite(twos, threes);
+  const auto both = IntSet::intersect(twos, threes);
+  ASSERT_EQ(either.get_size(), 2000);
+  ASSERT_EQ(both.get_size(), 500);
+
+  for (Signed_32 i = 0; i < 3000; i++) {
+    ASSERT_EQ(either.contains(i), Bool(i % 2 == 0 || i % 3 == 0));
+    ASSERT_EQ(both.contains(i), Bool(i % 6 == 0));
+  }
+
+  // Sources are left alone.
+  ASSERT_EQ(twos.get_size(), 1500);
+  ASSERT_EQ(threes.get_size(), 1000);
+
+  twos.merge(threes);
+  ASSERT_EQ(twos.get_size(), 2000);
+
+  IntSet empty;
+  ASSERT_EQ(IntSet::intersect(empty, threes).get_size(), 0);
+  ASSERT_EQ(IntSet::unite(empty, threes).get_size(), 1000);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicSet, bulk_operations) {
+  bulk_operations<MapVectorization::Scalar>(result);
+  bulk_operations<MapVectorization::Partial>(result);
+  bulk_operations<MapVectorization::Full>(result);
+  bulk_operations<MapVectorization::Wide>(result);
+}
+
+PERIMORTEM_UNIT_TEST(DynamicSet, smaller_than_map) {
+  Dynamic::Set<Signed_64> key_set(1000);
+  Dynamic::Map<Signed_64, Bool> flag_map(1000);
+
+  EXPECT_EQ(key_set.get_capacity(), flag_map.get_capacity());
+  EXPECT(key_set.get_memory_consumption() < flag_map.get_memory_consumption());
+
+  // 4 byte keys keep a 32 bit hash so vector slots shrink as well.
+  Dynamic::Set<Signed_32, MapVectorization::Full> packed_set(1000);
+  Dynamic::Map<Signed_32, Bool, MapVectorization::Full> packed_map(1000);
+  EXPECT_EQ(packed_set.get_capacity(), packed_map.get_capacity());
+  EXPECT(
+      packed_set.get_memory_consumption() <
+      packed_map.get_memory_consumption());
+}
+
+PERIMORTEM_UNIT_TEST(DynamicSet, leak_test) {
+  auto pre_test_memory = Bibliotheca::allocated_memory();
+
+  {
+    Dynamic::Set<Dynamic::Bytes, MapVectorization::Partial> text_set;
+    Dynamic::Bytes source;
+    for (Count i = 0; i < 100; i++) {
+      source.append('A');
+      text_set.insert(source);
+    }
+
+    auto copy = text_set;
+    auto both = decltype(text_set)::intersect(text_set, copy);
+    EXPECT_EQ(both.get_size(), 100);
+  }
+
+  auto post_test_memory = Bibliotheca::allocated_memory();
+  EXPECT_EQ(pre_test_memory, post_test_memory);
+}
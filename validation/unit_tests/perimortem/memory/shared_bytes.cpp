@@ -0,0 +1,93 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/bibliotheca.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+#include "perimortem/memory/dynamic/bytes.hpp"
+#include "perimortem/memory/shared/bytes.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Memory;
+
+using namespace Validation;
+
+static Harness SharedBytes = {
+  .name = "Shared::Bytes"_view,
+};
+
+static constexpr auto shared_text =
+    "header:alpha,beta,gamma;a payload long enough to need a block"_view;
+
+PERIMORTEM_UNIT_TEST(SharedBytes, owners) {
+  Shared::Bytes bytes(shared_text);
+  EXPECT(bytes == shared_text);
+  EXPECT_EQ(bytes.get_owner_count(), 1);
+
+  {
+    Shared::Bytes copy = bytes;
+    EXPECT_EQ(bytes.get_owner_count(), 2);
+    EXPECT(copy.get_view().get_data() == bytes.get_view().get_data());
+
+    Shared::Bytes moved = static_cast<Shared::Bytes&&>(copy);
+    EXPECT_EQ(bytes.get_owner_count(), 2);
+    EXPECT_EQ(copy.get_owner_count(), 0);
+    EXPECT(copy.is_empty());
+  }
+
+  EXPECT_EQ(bytes.get_owner_count(), 1);
+
+  Shared::Bytes empty;
+  EXPECT_EQ(empty.get_owner_count(), 0);
+  EXPECT(empty.slice(0, 4).is_empty());
+}
+
+PERIMORTEM_UNIT_TEST(SharedBytes, slices) {
+  const Count requests = Bibliotheca::check_out_requests();
+  Shared::Bytes bytes(shared_text);
+
+  Shared::Bytes header = bytes.slice(0, 6);
+  Shared::Bytes fields = bytes.slice(7, 16);
+  Shared::Bytes beta = fields.slice(6, 4);
+  Shared::Bytes tail = bytes.slice(24, 1000);
+
+  EXPECT(header == "header"_view);
+  EXPECT(fields == "alpha,beta,gamma"_view);
+  EXPECT(beta == "beta"_view);
+  EXPECT(tail == shared_text.slice(24, 1000));
+  EXPECT(bytes.slice(1000, 4).is_empty());
+
+  // One block shared by everyone.
+  EXPECT_EQ(Bibliotheca::check_out_requests(), requests + 1);
+  EXPECT_EQ(bytes.get_owner_count(), 5);
+
+  // The block outlives the original owner.
+  bytes.reset();
+  EXPECT_EQ(beta.get_owner_count(), 4);
+  EXPECT(beta == "beta"_view);
+  header = beta;
+  EXPECT(header == "beta"_view);
+  EXPECT_EQ(beta.get_owner_count(), 4);
+}
+
+PERIMORTEM_UNIT_TEST(SharedBytes, adopt_dynamic) {
+  Dynamic::Bytes decoded(shared_text);
+  const auto block = decoded.get_view().get_data();
+  const Count requests = Bibliotheca::check_out_requests();
+
+  Shared::Bytes bytes(static_cast<Dynamic::Bytes&&>(decoded));
+  EXPECT(bytes == shared_text);
+  EXPECT(bytes.get_view().get_data() == block);
+  EXPECT_EQ(bytes.get_owner_count(), 1);
+  EXPECT_EQ(Bibliotheca::check_out_requests(), requests);
+  EXPECT_EQ(decoded.get_size(), 0);
+
+  // Inline bytes have no block to take so they get copied into one.
+  Dynamic::Bytes small("tiny"_view);
+  Shared::Bytes small_shared(static_cast<Dynamic::Bytes&&>(small));
+  EXPECT(small_shared == "tiny"_view);
+  EXPECT_EQ(small_shared.get_owner_count(), 1);
+  EXPECT_EQ(small.get_size(), 0);
+}
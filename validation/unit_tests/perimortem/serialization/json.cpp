@@ -141,6 +141,15 @@ PERIMORTEM_UNIT_TEST(SerializationJson, parse_values) {
   value.parse(arena, "-130.4"_view);
   EXPECT_EQ(value.get_real(), -130.4);
 
+  value.parse(arena, "6.02214076e23"_view);
+  EXPECT_EQ(value.get_real(), 6.02214076e23);
+
+  value.parse(arena, "-1E-7"_view);
+  EXPECT_EQ(value.get_real(), -1e-7);
+
+  value.parse(arena, "0.30000000000000004"_view);
+  EXPECT_EQ(value.get_real(), 0.30000000000000004);
+
   value.parse(arena, "\"Sub View\""_view);
   EXPECT_TEXT(value.get_string(), "Sub View"_view);
 
@@ -402,6 +411,39 @@ PERIMORTEM_UNIT_TEST(SerializationJson, format_number_zero) {
   ASSERT_TEXT(formated, expected);
 }
 
+PERIMORTEM_UNIT_TEST(SerializationJson, format_real_round_trip) {
+  Allocator::Arena arena;
+  Json::Node value;
+
+  // Reals come back out as the shortest text that parses to the same value.
+  constexpr auto source = "[0.1,-2.5e-8,1e300,123456.789,5e-324]"_view;
+  value.parse(arena, source);
+  ASSERT_TEXT(value.format(arena), source);
+}
+
+PERIMORTEM_UNIT_TEST(SerializationJson, format_real_not_finite) {
+  Allocator::Arena arena;
+  const Json::Blueprint entries[] = {
+    {"nan"_view, __builtin_nan("")},
+    {"inf"_view, __builtin_inf()},
+    {"ninf"_view, -__builtin_inf()},
+    {"real"_view, 1.5},
+  };
+  auto value = Json::Node::construct(arena, entries);
+
+  // Values JSON can't spell come out as null so the output still parses.
+  constexpr auto expected =
+      "{\"nan\":null,\"inf\":null,\"ninf\":null,\"real\":1.5}"_view;
+  auto formated = value.format(arena);
+  ASSERT_TEXT(formated, expected);
+
+  Json::Node parsed;
+  parsed.parse(arena, formated);
+  ASSERT(parsed.is_object());
+  EXPECT(parsed["nan"_view].is_null());
+  EXPECT(parsed["real"_view].is_real());
+}
+
 PERIMORTEM_UNIT_TEST(SerializationJson, construct_existing_node) {
   Allocator::Arena arena;
 
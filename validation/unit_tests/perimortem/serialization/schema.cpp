@@ -0,0 +1,219 @@
+// Perimortem Engine
+// Copyright © Matt Kaes
+
+#include "perimortem/serialization/schema.hpp"
+
+#include "validation/unit_test.hpp"
+
+#include "perimortem/core/static/bytes.hpp"
+#include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/null_terminated.hpp"
+
+using namespace Perimortem::Core;
+using namespace Perimortem::Serialization;
+
+using namespace Validation;
+
+struct Position {
+  Real_32 x;
+  Real_32 y;
+  Real_32 z;
+};
+
+struct Player {
+  Bits_32 id;
+  Signed_16 health;
+  Bool alive;
+  View::Bytes name;
+  Position position;
+  Static::Vector<Signed_32, 4> scores;
+  Static::Vector<Real_64, 2> weights;
+  Static::Vector<Position, 2> waypoints;
+};
+
+struct Counters {
+  Static::Vector<Bits_32, 8> values;
+};
+
+struct Wide {
+  Bits_64 value;
+};
+
+struct Narrow {
+  Bits_8 value;
+};
+
+template <>
+struct Perimortem::Serialization::Schema<Position>
+    : Fields<&Position::x, &Position::y, &Position::z> {};
+
+template <>
+struct Perimortem::Serialization::Schema<Player>
+    : Fields<
+          &Player::id, &Player::health, &Player::alive, &Player::name,
+          &Player::position, &Player::scores, &Player::weights,
+          &Player::waypoints> {};
+
+template <>
+struct Perimortem::Serialization::Schema<Counters>
+    : Fields<&Counters::values> {};
+
+template <>
+struct Perimortem::Serialization::Schema<Wide> : Fields<&Wide::value> {};
+
+template <>
+struct Perimortem::Serialization::Schema<Narrow> : Fields<&Narrow::value> {};
+
+static auto make_player() -> Player {
+  Player player = {};
+  player.id = 0xC0FFEE;
+  player.health = -250;
+  player.alive = True;
+  player.name = "Perimortem"_view;
+  player.position = {1.5f, -2.25f, 1024.0f};
+  player.scores = Static::Vector<Signed_32, 4>(0, -1, 100000, -2000000000);
+  player.weights = Static::Vector<Real_64, 2>(0.125, -3.5e100);
+  player.waypoints[0] = {0.0f, 1.0f, 2.0f};
+  player.waypoints[1] = {-3.0f, -4.0f, -5.0f};
+  return player;
+}
+
+static auto expect_player(
+    Test::TestResult& result, const Player& lhs, const Player& rhs) -> void {
+  EXPECT_EQ(lhs.id, rhs.id);
+  EXPECT_EQ(lhs.health, rhs.health);
+  EXPECT(lhs.alive == rhs.alive);
+  EXPECT_TEXT(lhs.name, rhs.name);
+  EXPECT_EQ(lhs.position.x, rhs.position.x);
+  EXPECT_EQ(lhs.position.y, rhs.position.y);
+  EXPECT_EQ(lhs.position.z, rhs.position.z);
+  for (Count i = 0; i < lhs.scores.get_size(); i++) {
+    EXPECT_EQ(lhs.scores[i], rhs.scores[i]);
+  }
+  for (Count i = 0; i < lhs.weights.get_size(); i++) {
+    EXPECT_EQ(lhs.weights[i], rhs.weights[i]);
+  }
+  for (Count i = 0; i < lhs.waypoints.get_size(); i++) {
+    EXPECT_EQ(lhs.waypoints[i].x, rhs.waypoints[i].x);
+    EXPECT_EQ(lhs.waypoints[i].y, rhs.waypoints[i].y);
+    EXPECT_EQ(lhs.waypoints[i].z, rhs.waypoints[i].z);
+  }
+}
+
+static Harness SerializationSchema = {
+  .name = "Serialization::Schema"_view,
+};
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, binary_round_trip) {
+  const Player source = make_player();
+
+  Static::Bytes<256> little_buffer;
+  Writer::Binary<Data::ByteOrder::Little> little_writer(little_buffer);
+  EXPECT(Structured::write(little_writer, source));
+
+  Player little_result = {};
+  Reader::Binary<Data::ByteOrder::Little> little_reader(
+      little_buffer.get_view().slice(0, little_writer.get_location()));
+  EXPECT(Structured::read(little_reader, little_result));
+  EXPECT_EQ(little_reader.get_location(), little_writer.get_location());
+  expect_player(result, little_result, source);
+
+  Static::Bytes<256> big_buffer;
+  Writer::Binary<Data::ByteOrder::Big> big_writer(big_buffer);
+  EXPECT(Structured::write(big_writer, source));
+
+  Player big_result = {};
+  Reader::Binary<Data::ByteOrder::Big> big_reader(
+      big_buffer.get_view().slice(0, big_writer.get_location()));
+  EXPECT(Structured::read(big_reader, big_result));
+  expect_player(result, big_result, source);
+
+  // The id leads the record in the requested byte order.
+  EXPECT_HEX(little_buffer.get_view().slice(0, 4), "\xEE\xFF\xC0\x00"_view);
+  EXPECT_HEX(big_buffer.get_view().slice(0, 4), "\x00\xC0\xFF\xEE"_view);
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, serial_round_trip) {
+  const Player source = make_player();
+
+  Static::Bytes<256> buffer;
+  Writer::Serial writer(buffer);
+  EXPECT(Structured::write(writer, source));
+
+  Player decoded = {};
+  Reader::Serial reader(buffer.get_view().slice(0, writer.get_location()));
+  EXPECT(Structured::read(reader, decoded));
+  EXPECT(reader.is_empty());
+  expect_player(result, decoded, source);
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, serial_packed_array) {
+  Counters source = {};
+  source.values = Static::Vector<Bits_32, 8>(1, 2, 3, 4, 5, 6, 7, 300);
+
+  Static::Bytes<32> buffer;
+  Writer::Serial writer(buffer);
+  EXPECT(Structured::write(writer, source));
+
+  // A single blob of varints rather than a typed value per element.
+  EXPECT_EQ(writer.get_location(), 11);
+  EXPECT_HEX(
+      buffer.get_view().slice(0, 11),
+      "\x21\x09"
+      "\x01\x02\x03\x04\x05\x06\x07\xAC\x02"_view);
+
+  Counters decoded = {};
+  Reader::Serial reader(buffer.get_view().slice(0, writer.get_location()));
+  EXPECT(Structured::read(reader, decoded));
+  for (Count i = 0; i < source.values.get_size(); i++) {
+    EXPECT_EQ(decoded.values[i], source.values[i]);
+  }
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, serial_truncated) {
+  const Player source = make_player();
+
+  Static::Bytes<256> buffer;
+  Writer::Serial writer(buffer);
+  EXPECT(Structured::write(writer, source));
+
+  Player decoded = {};
+  Reader::Serial reader(buffer.get_view().slice(0, writer.get_location() - 1));
+  EXPECT_NOT(Structured::read(reader, decoded));
+  EXPECT(Test::error_contains("overran"_view));
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, binary_truncated) {
+  const Player source = make_player();
+
+  Static::Bytes<256> buffer;
+  Writer::Binary<Data::ByteOrder::Little> writer(buffer);
+  EXPECT(Structured::write(writer, source));
+
+  Player decoded = {};
+  Reader::Binary<Data::ByteOrder::Little> reader(
+      buffer.get_view().slice(0, writer.get_location() - 1));
+  EXPECT_NOT(Structured::read(reader, decoded));
+  EXPECT(Test::error_contains("over ran"_view));
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, serial_out_of_range) {
+  const Wide source = {300};
+
+  Static::Bytes<16> buffer;
+  Writer::Serial writer(buffer);
+  EXPECT(Structured::write(writer, source));
+
+  // 300 doesn't fit in the narrower field so the read should be rejected.
+  Narrow decoded = {};
+  Reader::Serial reader(buffer.get_view().slice(0, writer.get_location()));
+  EXPECT_NOT(Structured::read(reader, decoded));
+}
+
+PERIMORTEM_UNIT_TEST(SerializationSchema, write_overflow) {
+  const Player source = make_player();
+
+  Static::Bytes<16> buffer;
+  Writer::Serial writer(buffer);
+  EXPECT_NOT(Structured::write(writer, source));
+}
@@ -8,6 +8,7 @@
 #include <stdio.h>
 
 #include "perimortem/core/static/vector.hpp"
+#include "perimortem/core/reader/binary.hpp"
 #include "perimortem/core/bibliotheca.hpp"
 #include "perimortem/core/null_terminated.hpp"
 
@@ -127,6 +128,53 @@ PERIMORTEM_UNIT_TEST(SystemFile, file_contents) {
   EXPECT(File::remove(test_output_location));
 }
 
+#ifdef PERI_LINUX
+PERIMORTEM_UNIT_TEST(SystemFile, file_stream) {
+  using Reader = Reader::Binary<Data::ByteOrder::Little>;
+  EXPECT_NOT(FileStream("perimortem"_view).is_valid());
+
+  // A window much smaller than the file so reading has to refill it.
+  FileStream stream(test_file, 16);
+  ASSERT(stream.is_valid());
+  EXPECT_EQ(stream.get_size(), json_contents.get_size());
+
+  Reader reader(stream);
+  for (Count i = 0; i < json_contents.get_size(); i += 10) {
+    const auto expected = json_contents.slice(i, 10);
+    EXPECT_TEXT(reader.read_bytes(expected.get_size()), expected);
+  }
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+
+  // Can't read more than the window at once.
+  reader.reset();
+  reader.read_bytes(17);
+  EXPECT_NOT(reader.is_valid());
+}
+
+PERIMORTEM_UNIT_TEST(SystemFile, mapped_stream) {
+  using Reader = Reader::Binary<Data::ByteOrder::Little>;
+  EXPECT_NOT(MappedStream("perimortem"_view).is_valid());
+
+  MappedStream stream(test_file, 16);
+  ASSERT(stream.is_valid());
+  EXPECT_EQ(stream.get_size(), json_contents.get_size());
+
+  Reader reader(stream);
+  for (Count i = 0; i < json_contents.get_size(); i += 10) {
+    const auto expected = json_contents.slice(i, 10);
+    EXPECT_TEXT(reader.read_bytes(expected.get_size()), expected);
+  }
+  EXPECT(reader.is_valid());
+  EXPECT(reader.is_empty());
+
+  // Mappings grow to fit the read rather than failing.
+  reader.reset();
+  EXPECT_TEXT(reader.read_bytes(json_contents.get_size()), json_contents);
+  EXPECT(reader.is_valid());
+}
+#endif
+
 PERIMORTEM_UNIT_TEST(SystemFile, sync_empty_file) {
   File empty_file;
   File file;